@@ -0,0 +1,22 @@
+project "BloomBenchmarks"
+location "."
+kind "ConsoleApp"
+language "C++"
+
+includedirs {
+    "src"
+}
+
+defines {
+    "CATCH_CONFIG_ENABLE_BENCHMARKING"
+}
+
+files { 
+    "benchmarks/**.hpp",
+    "benchmarks/**.cpp",
+}
+
+links {
+    "Bloom", 
+    "utility" 
+}
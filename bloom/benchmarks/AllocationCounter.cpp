@@ -0,0 +1,31 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic_size_t gAllocationCount = 0;
+
+void* operator new(std::size_t size) {
+	++gAllocationCount;
+	if (void* const result = std::malloc(size ? size : 1)) {
+		return result;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+namespace bloom {
+	
+	std::size_t allocationCount() {
+		return gAllocationCount;
+	}
+	
+}
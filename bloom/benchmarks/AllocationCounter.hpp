@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+namespace bloom {
+	
+	/// Number of calls to global operator new since program start.
+	/// The counting replacement of operator new is defined in AllocationCounter.cpp.
+	std::size_t allocationCount();
+	
+}
@@ -0,0 +1,46 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Scene/Scene.hpp"
+
+#include <utl/format.hpp>
+#include <utl/vector.hpp>
+
+using namespace bloom;
+
+TEST_CASE("Entity spawning", "[!benchmark]") {
+	std::size_t const count = 50'000;
+	
+	BENCHMARK_ADVANCED(utl::format("createEntity() [{} entities]", count))(Catch::Benchmark::Chronometer meter) {
+		Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+		meter.measure([&]{
+			for (std::size_t i = 0; i < count; ++i) {
+				scene.createEntity("Entity");
+			}
+		});
+	};
+	
+	BENCHMARK_ADVANCED(utl::format("createEntities() [{} entities]", count))(Catch::Benchmark::Chronometer meter) {
+		Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+		meter.measure([&]{
+			return scene.createEntities(count, "Entity");
+		});
+	};
+	
+	BENCHMARK_ADVANCED(utl::format("deleteEntity() [{} entities]", count))(Catch::Benchmark::Chronometer meter) {
+		Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+		auto const entities = scene.createEntities(count, "Entity");
+		meter.measure([&]{
+			for (auto const entity: entities) {
+				scene.deleteEntity(entity);
+			}
+		});
+	};
+	
+	BENCHMARK_ADVANCED(utl::format("destroyEntities() [{} entities]", count))(Catch::Benchmark::Chronometer meter) {
+		Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+		auto const entities = scene.createEntities(count, "Entity");
+		meter.measure([&]{
+			scene.destroyEntities(entities);
+		});
+	};
+}
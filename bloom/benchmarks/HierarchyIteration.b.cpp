@@ -0,0 +1,82 @@
+#include <Catch2/Catch2.hpp>
+
+#include "AllocationCounter.hpp"
+
+#include "Bloom/Scene/Scene.hpp"
+
+using namespace bloom;
+
+namespace {
+	/// 64 chains of depth 32. Every node of a chain additionally has 16 leaf children.
+	Scene makeDeepScene() {
+		Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+		for (int i = 0; i < 64; ++i) {
+			EntityID parent = scene.createEntity("Root");
+			for (int depth = 0; depth < 32; ++depth) {
+				for (int j = 0; j < 16; ++j) {
+					scene.parent(scene.createEntity("Leaf"), parent);
+				}
+				auto const next = scene.createEntity("Node");
+				scene.parent(next, parent);
+				parent = next;
+			}
+		}
+		return scene;
+	}
+	
+	std::size_t visitGathered(Scene const& scene, EntityID entity) {
+		std::size_t result = 1;
+		for (auto const child: scene.gatherChildren(entity)) {
+			result += visitGathered(scene, child);
+		}
+		return result;
+	}
+	
+	std::size_t visitLazy(Scene const& scene, EntityID entity) {
+		std::size_t result = 1;
+		for (auto const child: scene.children(entity)) {
+			result += visitLazy(scene, child);
+		}
+		return result;
+	}
+}
+
+TEST_CASE("Hierarchy iteration", "[!benchmark]") {
+	Scene const scene = makeDeepScene();
+	
+	auto traverseGathered = [&]{
+		std::size_t count = 0;
+		for (auto const root: scene.gatherRoots()) {
+			count += visitGathered(scene, root);
+		}
+		return count;
+	};
+	auto traverseLazy = [&]{
+		std::size_t count = 0;
+		for (auto const root: scene.roots()) {
+			count += visitLazy(scene, root);
+		}
+		return count;
+	};
+	
+	std::size_t const gatheredBegin = allocationCount();
+	std::size_t const gatheredVisited = traverseGathered();
+	std::size_t const gatheredAllocations = allocationCount() - gatheredBegin;
+	
+	std::size_t const lazyBegin = allocationCount();
+	std::size_t const lazyVisited = traverseLazy();
+	std::size_t const lazyAllocations = allocationCount() - lazyBegin;
+	
+	CHECK(gatheredVisited == lazyVisited);
+	CHECK(lazyAllocations == 0);
+	WARN("Allocations per traversal of " << lazyVisited << " entities: gatherChildren() = "
+		 << gatheredAllocations << ", children() = " << lazyAllocations);
+	
+	BENCHMARK("Traverse with gatherRoots()/gatherChildren()") {
+		return traverseGathered();
+	};
+	
+	BENCHMARK("Traverse with roots()/children()") {
+		return traverseLazy();
+	};
+}
@@ -0,0 +1,4 @@
+// Catch2 is compiled into this target directly because the prebuilt
+// Catch2 library doesn't have benchmarking enabled.
+#define CATCH_CONFIG_MAIN
+#include <Catch2/Catch2.hpp>
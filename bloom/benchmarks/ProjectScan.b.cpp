@@ -0,0 +1,74 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Asset/AssetManager.hpp"
+#include "Bloom/Runtime/JobSystem.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <utl/format.hpp>
+#include <utl/stopwatch.hpp>
+
+using namespace bloom;
+
+namespace {
+	/// Writes a scene header to \p path. The scan only reads headers, so that is all the file contains.
+	AssetHandle writeAsset(std::filesystem::path const& path, std::string_view name) {
+		auto const handle = AssetHandle::generate(AssetType::scene);
+		AssetFileHeader const header(handle, FileFormat::text, name, SceneFileHeader{});
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<char const*>(&header), sizeof header);
+		return handle;
+	}
+	
+	double elapsedMS(auto&& function) {
+		utl::precise_stopwatch stopwatch;
+		function();
+		std::size_t const elapsedTimeNS = stopwatch.elapsed_time();
+		return elapsedTimeNS / 1'000'000.0;
+	}
+}
+
+TEST_CASE("Project scan", "[!benchmark]") {
+	std::size_t const count = 50'000;
+	std::size_t const directoryCount = 100;
+	auto const root = std::filesystem::temp_directory_path() / "bloom-project-scan-benchmark";
+	std::filesystem::remove_all(root);
+	utl::vector<std::filesystem::path> paths;
+	utl::vector<AssetHandle> handles;
+	for (std::size_t i = 0; i < count; ++i) {
+		auto const directory = root / utl::format("Directory{}", i % directoryCount);
+		if (i < directoryCount) {
+			std::filesystem::create_directories(directory);
+		}
+		auto const name = utl::format("Scene{}", i);
+		paths.push_back(directory / (name + ".bscene"));
+		handles.push_back(writeAsset(paths.back(), name));
+	}
+	auto const registryPath = root / AssetRegistry::fileName;
+	
+	// Files are in the page cache in every run, the numbers show the cost of opening them rather than disk latency.
+	AssetManager serial;
+	double const serialCold = elapsedMS([&]{ serial.setWorkingDir(root); });
+	REQUIRE(std::filesystem::exists(registryPath));
+	
+	JobSystem jobSystem;
+	AssetManager parallel(&jobSystem);
+	std::filesystem::remove(registryPath);
+	double const parallelCold = elapsedMS([&]{ parallel.setWorkingDir(root); });
+	double const warm = elapsedMS([&]{ parallel.setWorkingDir(root); });
+	
+	// An editing session touches a few files between refreshes.
+	for (std::size_t i = 0; i < count; i += 100) {
+		handles[i] = writeAsset(paths[i], utl::format("Scene{}", i));
+	}
+	double const incremental = elapsedMS([&]{ parallel.refreshWorkingDir(); });
+	
+	for (auto const handle: handles) {
+		CHECK(parallel.isValid(handle));
+	}
+	std::filesystem::remove_all(root);
+	
+	WARN(utl::format("Scanning {} assets: {:.1f} ms cold on 1 thread, {:.1f} ms cold on {} threads, "
+					 "{:.1f} ms from the registry, {:.1f} ms with {} changed files",
+					 count, serialCold, parallelCold, jobSystem.workerCount() + 1, warm, incremental, count / 100));
+}
@@ -0,0 +1,57 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Runtime/CoreRuntime.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utl/format.hpp>
+#include <utl/stopwatch.hpp>
+
+using namespace bloom;
+
+namespace {
+	struct EmptyDelegate: RuntimeDelegate {
+		void step(Timestep) override { steps.fetch_add(1, std::memory_order_relaxed); }
+		std::atomic_size_t steps = 0;
+	};
+	
+	/// Steps a runtime with an empty delegate as fast as possible for \p duration while \p poll runs on the calling thread.
+	/// Returns the throughput in steps per second.
+	double stepsPerSecond(std::chrono::milliseconds duration, auto&& poll) {
+		auto delegate = std::make_shared<EmptyDelegate>();
+		CoreRuntime runtime(delegate);
+		runtime.setUpdateOptions({ .stepsPerSecond = 0 });
+		
+		utl::precise_stopwatch stopwatch;
+		runtime.run();
+		auto const end = std::chrono::steady_clock::now() + duration;
+		while (std::chrono::steady_clock::now() < end) {
+			poll(runtime);
+		}
+		runtime.stop();
+		std::size_t const elapsedTimeNS = stopwatch.elapsed_time();
+		return double(delegate->steps) / (elapsedTimeNS / 1'000'000'000.0);
+	}
+}
+
+TEST_CASE("Runtime step dispatch", "[!benchmark]") {
+	auto const duration = std::chrono::milliseconds(500);
+	
+	double const idle = stepsPerSecond(duration, [](CoreRuntime&) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	});
+	// A render thread querying the runtime every iteration used to contend with the step loop for its mutex.
+	double const polled = stepsPerSecond(duration, [](CoreRuntime& runtime) {
+		(void)runtime.state();
+		(void)runtime.interpolationAlpha();
+	});
+	double const toggled = stepsPerSecond(duration, [](CoreRuntime& runtime) {
+		runtime.pause();
+		runtime.resume();
+	});
+	
+	WARN(utl::format("Empty steps: {:.2f} M/s ({:.0f} ns/step), {:.2f} M/s while polling state, "
+					 "{:.2f} M/s while pausing and resuming",
+					 idle / 1e6, 1e9 / idle, polled / 1e6, toggled / 1e6));
+}
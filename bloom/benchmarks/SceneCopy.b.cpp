@@ -0,0 +1,64 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Scene/Scene.hpp"
+
+#include <utl/format.hpp>
+
+using namespace bloom;
+
+TEST_CASE("Scene copy", "[!benchmark]") {
+	std::size_t const count = 100'000;
+	Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+	for (std::size_t i = 0; i < count; ++i) {
+		scene.createEntity(utl::format("Entity {}", i % 100));
+	}
+	
+	WARN(utl::format("sizeof(TagComponent) = {}", sizeof(TagComponent)));
+	
+	BENCHMARK(utl::format("Scene::copy() [{} entities]", count)) {
+		return scene.copy();
+	};
+	
+	// Entering and leaving play mode: take a copy, later move it back into the scene.
+	BENCHMARK_ADVANCED(utl::format("Play mode round trip [{} entities]", count))(Catch::Benchmark::Chronometer meter) {
+		Scene target = scene.copy();
+		meter.measure([&]{
+			Scene backup = target.copy();
+			target = std::move(backup);
+		});
+	};
+}
+
+TEST_CASE("Scene clone subtree", "[!benchmark]") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+	// A prefab-like hierarchy of 1 + 9 + 81 entities.
+	auto const root = scene.createEntity("Root");
+	for (int i = 0; i < 9; ++i) {
+		auto const child = scene.createEntity("Child");
+		scene.parent(child, root);
+		for (int j = 0; j < 9; ++j) {
+			scene.parent(scene.createEntity("Grandchild"), child);
+		}
+	}
+	
+	BENCHMARK_ADVANCED("cloneEntity + parent [91 entities]")(Catch::Benchmark::Chronometer meter) {
+		Scene target = scene.copy();
+		meter.measure([&]{
+			auto const rootClone = target.cloneEntity(root);
+			for (auto const child: target.children(root)) {
+				auto const childClone = target.cloneEntity(child);
+				target.parent(childClone, rootClone);
+				for (auto const grandchild: target.children(child)) {
+					target.parent(target.cloneEntity(grandchild), childClone);
+				}
+			}
+		});
+	};
+	
+	BENCHMARK_ADVANCED("cloneSubtree [91 entities]")(Catch::Benchmark::Chronometer meter) {
+		Scene target = scene.copy();
+		meter.measure([&]{
+			return target.cloneSubtree(root);
+		});
+	};
+}
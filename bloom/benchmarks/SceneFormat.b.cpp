@@ -0,0 +1,70 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Asset/AssetManager.hpp"
+#include "Bloom/Scene/Scene.hpp"
+
+#include <sstream>
+#include <utl/format.hpp>
+#include <utl/stopwatch.hpp>
+
+using namespace bloom;
+
+namespace {
+	double elapsedMS(auto&& function) {
+		utl::precise_stopwatch stopwatch;
+		function();
+		std::size_t const elapsedTimeNS = stopwatch.elapsed_time();
+		return elapsedTimeNS / 1'000'000.0;
+	}
+}
+
+TEST_CASE("Scene formats", "[!benchmark]") {
+	std::size_t const count = 100'000;
+	Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+	// Groups of a parent with nine children, every group lit by a point light.
+	EntityID parent;
+	for (std::size_t i = 0; i < count; ++i) {
+		auto const entity = scene.createEntity(utl::format("Entity {}", i % 100));
+		entity.get<Transform>().position = { float(i % 7), float(i % 11), float(i % 13) };
+		if (i % 10 == 0) {
+			parent = entity;
+			entity.add(PointLightComponent{});
+		}
+		else {
+			scene.parent(entity, parent);
+		}
+	}
+	AssetManager assetManager;
+	
+	std::string text;
+	double const textSave = elapsedMS([&]{
+		YAML::Emitter out;
+		out << scene.serialize();
+		text = out.c_str();
+	});
+	double const textLoad = elapsedMS([&]{
+		Scene loaded(scene.handle(), "Text");
+		loaded.deserialize(YAML::Load(text), assetManager);
+	});
+	double const textStream = elapsedMS([&]{
+		std::istringstream stream(text);
+		Scene loaded(scene.handle(), "Streamed");
+		loaded.deserialize(stream, assetManager);
+	});
+	
+	std::string binary;
+	double const binarySave = elapsedMS([&]{
+		std::ostringstream stream;
+		scene.serializeBinary(stream);
+		binary = std::move(stream).str();
+	});
+	double const binaryLoad = elapsedMS([&]{
+		std::istringstream stream(binary);
+		Scene loaded(scene.handle(), "Binary");
+		loaded.deserializeBinary(stream, assetManager);
+	});
+	
+	WARN(utl::format("{} entities as text: {:.1f} MB, save {:.1f} ms, load {:.1f} ms, streamed load {:.1f} ms",
+					 count, text.size() / 1e6, textSave, textLoad, textStream));
+	WARN(utl::format("{} entities as binary: {:.1f} MB, save {:.1f} ms, load {:.1f} ms", count, binary.size() / 1e6, binarySave, binaryLoad));
+}
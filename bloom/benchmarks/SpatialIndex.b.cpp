@@ -0,0 +1,106 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Scene/SpatialIndex.hpp"
+
+#include <random>
+#include <utl/format.hpp>
+#include <utl/stopwatch.hpp>
+#include <utl/vector.hpp>
+
+using namespace bloom;
+
+namespace {
+	/// Runs \p function once and returns the throughput in operations per second.
+	double operationsPerSecond(std::size_t operationCount, auto&& function) {
+		utl::precise_stopwatch stopwatch;
+		function();
+		std::size_t const elapsedTimeNS = stopwatch.elapsed_time();
+		return double(operationCount) / (elapsedTimeNS / 1'000'000'000.0);
+	}
+	
+	AABB makeBox(mtl::float3 center) {
+		return { center - 0.5f, center + 0.5f };
+	}
+}
+
+TEST_CASE("Spatial index", "[!benchmark]") {
+	std::size_t const count = 100'000;
+	std::mt19937 rng(0);
+	// Objects spread over a 1 km cube.
+	std::uniform_real_distribution<float> position(-500, 500);
+	utl::vector<mtl::float3> centers(count);
+	for (auto& center: centers) {
+		center = { position(rng), position(rng), position(rng) };
+	}
+	
+	SpatialIndex index;
+	utl::vector<SpatialIndex::ProxyID> proxies(count);
+	double const insertRate = operationsPerSecond(count, [&]{
+		for (std::size_t i = 0; i < count; ++i) {
+			proxies[i] = index.insert(makeBox(centers[i]), EntityID(EntityID::RawType(i)));
+		}
+	});
+	
+	// Moves within the fat margin leave the tree alone, moves out of it reinsert the leaf.
+	auto moveAll = [&](float distance) {
+		for (std::size_t i = 0; i < count; ++i) {
+			centers[i].x += distance;
+			index.update(proxies[i], makeBox(centers[i]));
+		}
+	};
+	double const smallMoveRate = operationsPerSecond(count, [&]{ moveAll(0.01f); });
+	double const largeMoveRate = operationsPerSecond(count, [&]{ moveAll(1.0f); });
+	
+	std::size_t const queryCount = 10'000;
+	std::size_t results = 0;
+	double const boxQueryRate = operationsPerSecond(queryCount, [&]{
+		for (std::size_t i = 0; i < queryCount; ++i) {
+			AABB const box = { centers[i] - 10.0f, centers[i] + 10.0f };
+			index.query(box, [&](EntityID) { ++results; });
+		}
+	});
+	
+	WARN(utl::format("{} objects, tree height {}: insert {:.2f} M/s, update in margin {:.2f} M/s, "
+					 "update with reinsertion {:.2f} M/s, 20 m box queries {:.2f} M/s ({} results)",
+					 count, index.height(),
+					 insertRate / 1e6, smallMoveRate / 1e6, largeMoveRate / 1e6, boxQueryRate / 1e6, results));
+	
+	BENCHMARK(utl::format("Update, 1% reinserted [{} objects]", count)) {
+		for (std::size_t i = 0; i < count; ++i) {
+			centers[i].y += i % 100 == 0 ? 1.0f : 0.001f;
+			index.update(proxies[i], makeBox(centers[i]));
+		}
+	};
+	
+	BENCHMARK(utl::format("AABB query, 20 m box [{} objects]", count)) {
+		std::size_t n = 0;
+		index.query(AABB{ -10.0f, 10.0f }, [&](EntityID) { ++n; });
+		return n;
+	};
+	
+	BENCHMARK(utl::format("Sphere query, 50 m radius [{} objects]", count)) {
+		std::size_t n = 0;
+		index.query(Sphere{ .center = 0, .radius = 50 }, [&](EntityID) { ++n; });
+		return n;
+	};
+	
+	BENCHMARK(utl::format("Frustum query, 90 degree perspective [{} objects]", count)) {
+		mtl::float4x4 const viewProjection = mtl::infinite_perspective<mtl::right_handed>(1.57f, 1.0f, 0.1f) *
+			mtl::look_at<mtl::right_handed>(mtl::float3(0), mtl::float3{ 0, 1, 0 }, mtl::float3{ 0, 0, 1 });
+		std::size_t n = 0;
+		index.query(Frustum(viewProjection), [&](EntityID) { ++n; });
+		return n;
+	};
+	
+	BENCHMARK(utl::format("Raycast, closest hit [{} objects]", count)) {
+		return index.raycast(Ray{ .origin = { -600, 0, 0 }, .direction = { 1, 0, 0 } });
+	};
+	
+	BENCHMARK(utl::format("Build from scratch [{} objects]", count)) {
+		SpatialIndex fresh;
+		for (std::size_t i = 0; i < count; ++i) {
+			fresh.insert(makeBox(centers[i]), EntityID(EntityID::RawType(i)));
+		}
+		return fresh.size();
+	};
+}
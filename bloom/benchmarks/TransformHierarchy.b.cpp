@@ -0,0 +1,119 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Core/ThreadPool.hpp"
+#include "Bloom/Scene/Scene.hpp"
+
+#include <utl/format.hpp>
+#include <utl/vector.hpp>
+
+using namespace bloom;
+
+namespace {
+	/// Builds a forest of static props. Every root has 9 children, every child has 9 children of its own.
+	Scene makeScene(std::size_t entityCount, utl::vector<EntityID>& entities) {
+		Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+		entities.clear();
+		entities.reserve(entityCount);
+		while (entities.size() < entityCount) {
+			auto const root = scene.createEntity("Root");
+			entities.push_back(root);
+			for (int i = 0; i < 9 && entities.size() < entityCount; ++i) {
+				auto const child = scene.createEntity("Child");
+				child.get<Transform>().position = { float(i), 0, 0 };
+				scene.parent(child, root);
+				entities.push_back(child);
+				for (int j = 0; j < 9 && entities.size() < entityCount; ++j) {
+					auto const grandchild = scene.createEntity("Grandchild");
+					grandchild.get<Transform>().position = { 0, float(j), 0 };
+					scene.parent(grandchild, child);
+					entities.push_back(grandchild);
+				}
+			}
+		}
+		scene.applyTransformHierarchy({ .incremental = false });
+		return scene;
+	}
+}
+
+TEST_CASE("Transform hierarchy update", "[!benchmark]") {
+	ThreadPool threadPool;
+	for (std::size_t const entityCount: { 10'000, 100'000 }) {
+		utl::vector<EntityID> entities;
+		Scene scene = makeScene(entityCount, entities);
+		
+		BENCHMARK(utl::format("Full update [{} entities]", entityCount)) {
+			scene.applyTransformHierarchy({ .incremental = false });
+		};
+		
+		BENCHMARK(utl::format("Incremental update, nothing moved [{} entities]", entityCount)) {
+			scene.applyTransformHierarchy({ .incremental = true });
+		};
+		
+		BENCHMARK(utl::format("Incremental update, 1% moved [{} entities]", entityCount)) {
+			for (std::size_t i = 0; i < entities.size(); i += 100) {
+				scene.getComponent<Transform>(entities[i]).position.z += 1;
+				scene.markTransformDirty(entities[i]);
+			}
+			scene.applyTransformHierarchy({ .incremental = true });
+		};
+		
+		// Every entity is dirty after a load, a copy or restoring the scene after play mode.
+		BENCHMARK(utl::format("Incremental update, all moved [{} entities]", entityCount)) {
+			for (auto const entity: entities) {
+				scene.markTransformDirty(entity);
+			}
+			scene.applyTransformHierarchy({ .incremental = true });
+		};
+		
+		BENCHMARK(utl::format("Parallel full update, {} workers [{} entities]", threadPool.workerCount(), entityCount)) {
+			scene.applyTransformHierarchy({ .incremental = false, .threadPool = &threadPool });
+		};
+		
+		BENCHMARK(utl::format("Parallel incremental update, 1% moved, {} workers [{} entities]", threadPool.workerCount(), entityCount)) {
+			for (std::size_t i = 0; i < entities.size(); i += 100) {
+				scene.getComponent<Transform>(entities[i]).position.z += 1;
+				scene.markTransformDirty(entities[i]);
+			}
+			scene.applyTransformHierarchy({ .incremental = true, .threadPool = &threadPool });
+		};
+		
+		BENCHMARK(utl::format("Packed full update [{} entities]", entityCount)) {
+			scene.applyTransformHierarchy({ .incremental = false, .packed = true });
+		};
+		
+		BENCHMARK(utl::format("Packed incremental update, 1% moved [{} entities]", entityCount)) {
+			for (std::size_t i = 0; i < entities.size(); i += 100) {
+				scene.getComponent<Transform>(entities[i]).position.z += 1;
+				scene.markTransformDirty(entities[i]);
+			}
+			scene.applyTransformHierarchy({ .incremental = true, .packed = true });
+		};
+	}
+}
+
+TEST_CASE("Transform hierarchy update of a deep chain", "[!benchmark]") {
+	// Walking the ancestors of every dirty entity is quadratic in the depth of a chain.
+	for (std::size_t const entityCount: { 1'000, 10'000 }) {
+		Scene scene(AssetHandle::generate(AssetType::scene), "Benchmark Scene");
+		utl::vector<EntityID> entities;
+		entities.reserve(entityCount);
+		for (std::size_t i = 0; i < entityCount; ++i) {
+			auto const entity = scene.createEntity("Link");
+			if (!entities.empty()) {
+				scene.parent(entity, entities.back());
+			}
+			entities.push_back(entity);
+		}
+		
+		BENCHMARK(utl::format("Full update [{} entities]", entityCount)) {
+			scene.applyTransformHierarchy({ .incremental = false });
+		};
+		
+		BENCHMARK(utl::format("Incremental update, all moved [{} entities]", entityCount)) {
+			for (auto const entity: entities) {
+				scene.markTransformDirty(entity);
+			}
+			scene.applyTransformHierarchy({ .incremental = true });
+		};
+	}
+}
@@ -0,0 +1,61 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Scene/Components/Transform.hpp"
+#include "Bloom/Scene/TransformKernels.hpp"
+
+#include <utl/format.hpp>
+#include <utl/stopwatch.hpp>
+#include <utl/vector.hpp>
+
+using namespace bloom;
+
+namespace {
+	/// Runs \p function \p repetitions times and returns the throughput in matrices per second.
+	double matricesPerSecond(std::size_t matrixCount, std::size_t repetitions, auto&& function) {
+		utl::precise_stopwatch stopwatch;
+		for (std::size_t i = 0; i < repetitions; ++i) {
+			function();
+		}
+		std::size_t const elapsedTimeNS = stopwatch.elapsed_time();
+		double const seconds = elapsedTimeNS / 1'000'000'000.0;
+		return double(matrixCount * repetitions) / seconds;
+	}
+}
+
+TEST_CASE("Batch transform kernels", "[!benchmark]") {
+	std::size_t const count = 100'000;
+	utl::vector<Transform> transforms(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		transforms[i].position = { float(i), 0, 0 };
+		transforms[i].orientation = mtl::normalize(mtl::quaternion_float(1, 0.001f * float(i), 0, 0));
+	}
+	utl::vector<mtl::float4x4> matrices(count);
+	mtl::float4x4 const parent = transforms[42].calculate();
+	
+	for (auto const path: { SIMDPath::scalar, SIMDPath::sse, SIMDPath::avx2 }) {
+		if (path > bestSIMDPath()) {
+			continue;
+		}
+		auto calculate = [&]{
+			calculateTransforms(transforms.data(), matrices.data(), count, path);
+			return matrices[count / 2];
+		};
+		auto multiply = [&]{
+			multiplyMatrices(parent, matrices.data(), matrices.data(), count, path);
+			return matrices[count / 2];
+		};
+		
+		WARN(utl::format("{}: calculateTransforms {:.1f} M matrices/s, multiplyMatrices {:.1f} M matrices/s",
+						 toString(path),
+						 matricesPerSecond(count, 100, calculate) / 1e6,
+						 matricesPerSecond(count, 100, multiply) / 1e6));
+		
+		BENCHMARK(utl::format("calculateTransforms, {} [{} transforms]", toString(path), count)) {
+			return calculate();
+		};
+		
+		BENCHMARK(utl::format("multiplyMatrices, {} [{} matrices]", toString(path), count)) {
+			return multiply();
+		};
+	}
+}
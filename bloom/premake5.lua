@@ -53,4 +53,21 @@ filter  "system:macosx"
     }
 filter {}
 
+-- Application/HeadlessWindow.cpp replaces the window system
+filter "options:headless"
+    removefiles {
+        "src/Bloom/platform/**",
+        "src/Bloom/Application/Window.cpp",
+        "src/Bloom/Application/Input.cpp",
+    }
+
+    removelinks {
+        "glfw3",
+        "AppKit.framework",
+        "Metal.framework",
+        "IOKit.framework",
+        "QuartzCore.framework"
+    }
+filter {}
+
 removefiles "./**-depr.**"
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "Bloom/Core/Autorelease.hpp"
 #include "Window.hpp"
 
+#include "Bloom/Runtime/JobSystem.hpp"
+#include "Bloom/Runtime/SceneSystem.hpp"
+
 #include <numeric>
 #include <iostream>
 
@@ -17,6 +20,7 @@ int main(int argc, char const** argv, char const** env) {
 	theApp->cmdLineArgs = cmdArgs;
 
 	theApp->run();
+	return theApp->exitCode();
 }
 
 bloom::Application* bloom::createApplication() {
@@ -103,7 +107,9 @@ namespace bloom {
 	void Application::doInit() {
 		registerListeners();
 		
-		initWindowSystem();
+		if (!isHeadless()) {
+			initWindowSystem();
+		}
 		
 		mCoreSystems.init();
 		
@@ -128,6 +134,8 @@ namespace bloom {
 	/// MARK: Frame
 	void Application::doFrame() {
 		MessageSystem::flush();
+		mCoreSystems.jobSystem().runMainThreadTasks();
+		mCoreSystems.sceneSystem().update();
 		
 		BLOOM_AUTORELEASE_BEGIN
 		this->frame();
@@ -49,11 +49,16 @@ namespace bloom {
 		virtual void shutdown() {}
 		virtual void frame() {}
 		
+		/// Headless applications run without window system and GPU device. They create no windows,
+		/// so \p run() returns right after \p init(), which is expected to do all the work.
+		virtual bool isHeadless() const { return false; }
+		
 		/// MARK: Queries
 		CommandLineArgs commandLineArgs() const { return cmdLineArgs; }
 		HardwareDevice& device() { return coreSystems().device(); }
 		CoreSystemManager& coreSystems() { return mCoreSystems; }
 		Timestep time() const { return mTimer.timestep(); }
+		int exitCode() const { return mExitCode; }
 		
 		utl::small_vector<Window*> getWindows();
 		auto windows() {
@@ -67,6 +72,9 @@ namespace bloom {
 		Window& createWindow(WindowDescription const&, std::unique_ptr<WindowDelegate> = nullptr);
 		Window& createWindow(WindowDescription const&, WindowDelegate*);
 		
+		/// Value returned from \p main().
+		void setExitCode(int code) { mExitCode = code; }
+		
 	private:
 		/// MARK: Private
 		void run();
@@ -88,6 +96,7 @@ namespace bloom {
 		Timer mTimer;
 		
 		std::size_t mFrameCounter = 0;
+		int mExitCode = 0;
 	};
 	
 }
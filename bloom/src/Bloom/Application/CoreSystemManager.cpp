@@ -8,6 +8,7 @@
 #include "Bloom/Asset/AssetManager.hpp"
 #include "Bloom/ScriptEngine/ScriptEngine.hpp"
 
+#include "Bloom/Runtime/JobSystem.hpp"
 #include "Bloom/Runtime/ScriptSystem.hpp"
 
 #include "Bloom/Runtime/CoreRuntime.hpp"
@@ -24,24 +25,33 @@ namespace bloom {
 	}
 	
 	void CoreSystemManager::init() {
-		mDevice       = HardwareDevice::create(RenderAPI::metal);
-		mRenderer     = createForwardRenderer(*mApp);
-		mRenderer->init(device());
+		if (!mApp->isHeadless()) {
+			mDevice   = HardwareDevice::create(RenderAPI::metal);
+			mRenderer = createForwardRenderer(*mApp);
+			mRenderer->init(device());
+		}
+		
+		// JobSystem
+		mJobSystem    = makeCoreSystem<JobSystem>();
 		
 		// AssetManager
-		mAssetManager = makeCoreSystem<AssetManager>();
+		mAssetManager = makeCoreSystem<AssetManager>(&jobSystem());
 		
 		// ScriptEngine
 		mScriptEngine = makeCoreSystem<ScriptEngine>();
 		
 		// ScriptSystem
 		mScriptSystem = makeCoreSystem<ScriptSystem>(scriptEngine());
+		mScriptSystem->init();
 		
 		// Runtime
 		mRuntime      = makeCoreSystem<CoreRuntime>();
 		
 		// SceneSystem
-		mSceneSystem  = makeCoreSystem<SceneSystem>();
+		mSceneSystem  = makeCoreSystem<SceneSystem>(jobSystem().threadPool());
+		mSceneSystem->setSceneReader([&assetManager = assetManager()](AssetHandle handle) {
+			return assetManager.readScene(handle);
+		});
 		mRuntime->setDelegate(mSceneSystem);
 	}
 	
@@ -10,6 +10,7 @@ namespace bloom {
 	
 	class HardwareDevice;
 	class Renderer;
+	class JobSystem;
 	class AssetManager;
 	class ScriptEngine;
 	class ScriptSystem;
@@ -27,8 +28,12 @@ namespace bloom {
 		void init();
 		void shutdown();
 		
+		/// False when running headless.
+		bool hasDevice() const { return mDevice != nullptr; }
+		
 		HardwareDevice& device()       { return *mDevice;       }
 		Renderer&       renderer()     { return *mRenderer;     }
+		JobSystem&      jobSystem()    { return *mJobSystem;    }
 		AssetManager&   assetManager() { return *mAssetManager; }
 		ScriptEngine&   scriptEngine() { return *mScriptEngine; }
 		
@@ -48,6 +53,8 @@ namespace bloom {
 		Application* mApp = nullptr;
 		std::unique_ptr<HardwareDevice> mDevice;
 		std::unique_ptr<Renderer>       mRenderer;
+		/// Declared before the systems that use it, so it outlives them.
+		std::unique_ptr<JobSystem>      mJobSystem;
 		std::unique_ptr<AssetManager>   mAssetManager;
 		std::unique_ptr<ScriptEngine>   mScriptEngine;
 		
@@ -0,0 +1,64 @@
+#include "Window.hpp"
+
+#ifdef BLOOM_HEADLESS // Window.cpp implements windows with GLFW otherwise
+
+#include <stdexcept>
+
+namespace bloom {
+	
+	/// MARK: - Statics
+	///
+	/// Headless builds link no window system. Only headless applications can run on them, see \p Application::isHeadless().
+	void initWindowSystem() {
+		throw std::runtime_error("Bloom was built without a window system");
+	}
+	
+	void pollWindowEvents() {
+		
+	}
+	
+	void waitWindowEvents() {
+		
+	}
+	
+	/// MARK: - Initialization
+	///
+	///
+	Window::Window(WindowDescription const&) {
+		throw std::runtime_error("Bloom was built without a window system");
+	}
+	
+	Window::~Window() = default;
+	
+	/// MARK: Update
+	///
+	///
+	void Window::beginFrame() {
+		
+	}
+	
+	void Window::endFrame() {
+		
+	}
+	
+	/// MARK: Queries
+	///
+	///
+	bool Window::shouldClose() const {
+		return true;
+	}
+	
+	/// MARK: Modifiers
+	///
+	///
+	void Window::setFocused() {
+		
+	}
+	
+	void Window::Deleter::operator()(void*) const {
+		
+	}
+	
+}
+
+#endif
@@ -2,7 +2,9 @@
 
 #include <ostream>
 
+#ifndef BLOOM_HEADLESS
 #include <GLFW/glfw3.h>
+#endif
 
 namespace bloom {
 	
@@ -29,6 +31,7 @@ namespace bloom {
 		return str << toString(e);
 	}
 	
+#ifndef BLOOM_HEADLESS
 	InputEvent inputEventFromGLFWMouseButton(Input const& input, int buttonCode, int action, int mods) {
 		auto const [type, button] = [&]{
 			switch (buttonCode) {
@@ -130,4 +133,5 @@ namespace bloom {
 		}
 	}
 	
+#endif
 }
@@ -24,6 +24,9 @@ namespace bloom {
 		if (extension == ".chai") {
 			return FileExtension::chai;
 		}
+		if (extension == ".bprefab") {
+			return FileExtension::bprefab;
+		}
 		return FileExtension::invalid;
 	}
 	
@@ -54,7 +57,8 @@ namespace bloom {
 			"Material",
 			"Material Instance",
 			"Scene",
-			"Script"
+			"Script",
+			"Prefab"
 		}[utl::log2(i)];
 	}
 	
@@ -74,6 +78,9 @@ namespace bloom {
 		if (str == "Scene") {
 			return AssetType::scene;
 		}
+		if (str == "Prefab") {
+			return AssetType::prefab;
+		}
 		return AssetType::none;
 	}
 	
@@ -94,6 +101,7 @@ namespace bloom {
 			".bmatinst",
 			".bscene",
 			".chai",
+			".bprefab",
 		}[utl::log2(i)];
 	}
 	BLOOM_API AssetType toAssetType(FileExtension ext) {
@@ -113,6 +121,9 @@ namespace bloom {
 			case FileExtension::chai:
 				return AssetType::script;
 				
+			case FileExtension::bprefab:
+				return AssetType::prefab;
+				
 			default:
 				return AssetType::none;
 		}
@@ -135,6 +146,9 @@ namespace bloom {
 			case FileExtension::chai:
 				return FileFormat::text;
 				
+			case FileExtension::bprefab:
+				return FileFormat::text;
+				
 			default:
 				return FileFormat::text;
 		}
@@ -32,7 +32,9 @@ namespace bloom {
 		
 		script       = 1 << 5,
 		
-		itemCount    = 6
+		prefab       = 1 << 6,
+		
+		itemCount    = 7
 	};
 	UTL_ENUM_OPERATORS(AssetType);
 	
@@ -42,7 +44,8 @@ namespace bloom {
 		bmat,
 		bmatinst,
 		bscene,
-		chai
+		chai,
+		bprefab
 	};
 	
 	FileExtension toExtension(std::filesystem::path const&);
@@ -116,6 +119,7 @@ namespace bloom {
 	class MaterialInstance;
 	class Scene;
 	class Script;
+	class Prefab;
 	
 	auto dispatchAssetType(AssetType type, auto&& f) {
 		switch (type) {
@@ -129,6 +133,8 @@ namespace bloom {
 				return f(utl::tag<Scene>{});
 			case AssetType::script:
 				return f(utl::tag<Script>{});
+			case AssetType::prefab:
+				return f(utl::tag<Prefab>{});
 				
 			default:
 				bloomDebugbreak();
@@ -62,5 +62,9 @@ namespace bloom {
 		
 	};
 	
+	struct PrefabFileHeader {
+		
+	};
+	
 	
 }
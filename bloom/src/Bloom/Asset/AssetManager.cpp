@@ -3,8 +3,10 @@
 #include "MeshImporter.hpp"
 
 #include "Bloom/Core/Core.hpp"
+#include "Bloom/Core/MappedFile.hpp"
 #include "Bloom/Application/Application.hpp"
 #include "Bloom/GPU/HardwareDevice.hpp"
+#include "Bloom/Runtime/JobSystem.hpp"
 
 #include "Bloom/Graphics/StaticMesh.hpp"
 #include "Bloom/Graphics/Material/Material.hpp"
@@ -12,6 +14,8 @@
 #include "Bloom/Script/Script.hpp"
 #include "Bloom/ScriptEngine/ScriptEngine.hpp"
 
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <utl/filesystem_ext.hpp>
 
@@ -35,12 +39,24 @@ namespace bloom {
 //		}
 //	}
 
-	AssetManager::~AssetManager() = default;
+	AssetManager::AssetManager(JobSystem* jobSystem):
+		_jobSystem(jobSystem)
+	{
+		
+	}
+	
+	AssetManager::~AssetManager() {
+		if (_jobSystem) {
+			// Workers may still be reading assets for us.
+			_jobSystem->waitIdle();
+		}
+	}
 	
 	HardwareDevice& AssetManager::device() const { return application().device(); };
 	
 	/// MARK: - Environment
 	void AssetManager::setWorkingDir(std::filesystem::path path) {
+		std::unique_lock lock(_mutex);
 		_workingDir = path.lexically_normal();
 		if (!std::filesystem::exists(_workingDir)) {
 			std::filesystem::create_directories(_workingDir);
@@ -48,22 +64,81 @@ namespace bloom {
 		
 		// load working dir
 		assets.clear();
+		_registry.clear();
+		if (std::ifstream file(_workingDir / AssetRegistry::fileName, std::ios::binary); file) {
+			_registry.read(file);
+		}
 		refreshWorkingDir();
 	}
 	
 	void AssetManager::refreshWorkingDir(bool forceOverrides) {
+		std::unique_lock lock(_mutex);
 		if (_workingDir.empty()) {
 			return;
 		}
-		auto dirItr = std::filesystem::recursive_directory_iterator(workingDir());
-		for (auto const& entry: dirItr) {
-			if (!std::filesystem::is_regular_file(entry.path())) {
+		
+		struct ScannedFile {
+			std::filesystem::path path;
+			std::string relativePath;
+			AssetRegistryEntry entry;
+			bool valid = false;
+		};
+		utl::vector<ScannedFile> files;
+		utl::vector<std::size_t> changed;
+		for (auto const& dirEntry: std::filesystem::recursive_directory_iterator(workingDir())) {
+			if (!dirEntry.is_regular_file() || utl::is_hidden(dirEntry.path())) {
 				continue;
 			}
-			if (utl::is_hidden(entry.path())) {
+			auto const modificationTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				dirEntry.last_write_time().time_since_epoch()).count();
+			auto const size = dirEntry.file_size();
+			ScannedFile file{ dirEntry.path(), dirEntry.path().lexically_relative(_workingDir).generic_string() };
+			if (auto const* const cached = _registry.find(file.relativePath, modificationTime, size)) {
+				file.entry = *cached;
+				file.valid = true;
+			}
+			else {
+				file.entry = { .modificationTime = modificationTime, .size = size };
+				changed.push_back(files.size());
+			}
+			files.push_back(std::move(file));
+		}
+		
+		// Only files that changed since the last scan are opened.
+		auto readHeaders = [&](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) {
+				auto& file = files[changed[i]];
+				try {
+					AssetFileHeader const header = readHeader(file.path);
+					file.entry.handle = header.handle();
+					file.entry.name = header.name();
+					file.valid = true;
+				}
+				catch (std::exception const& e) {
+					bloomLog(error, "Failed to read asset header of {}: {}", file.path, e.what());
+				}
+			}
+		};
+		if (_jobSystem) {
+			_jobSystem->parallelFor(changed.size(), 64, readHeaders);
+		}
+		else {
+			readHeaders(0, changed.size());
+		}
+		
+		// Rebuilt from the scan, so files that were removed drop out of the cache.
+		AssetRegistry registry;
+		for (auto& file: files) {
+			if (!file.valid) {
 				continue;
 			}
-			readAssetMetaData(entry.path(), forceOverrides);
+			insertAsset(file.path, file.entry.handle, file.entry.name, forceOverrides);
+			registry.insert(std::move(file.relativePath), std::move(file.entry));
+		}
+		bool const modified = !changed.empty() || registry.size() != _registry.size();
+		_registry = std::move(registry);
+		if (modified) {
+			writeRegistry();
 		}
 	}
 
@@ -72,6 +147,7 @@ namespace bloom {
 										  std::string_view name,
 										  std::filesystem::path dest)
 	{
+		std::unique_lock lock(_mutex);
 		auto const handle = AssetHandle::generate(type);
 		Reference<Asset> const ref = allocateAsset(handle, std::string(name));
 		InternalAsset asset {
@@ -89,6 +165,7 @@ namespace bloom {
 	AssetHandle AssetManager::import(std::filesystem::path source,
 									 std::filesystem::path dest)
 	{
+		std::unique_lock lock(_mutex);
 		std::string const name = source.filename().replace_extension();
 		AssetType const type = getImportType(source.extension().string());
 		
@@ -144,6 +221,7 @@ namespace bloom {
 	
 	/// MARK: - Remove
 	void AssetManager::remove(AssetHandle handle) {
+		std::unique_lock lock(_mutex);
 		auto const itr = assets.find(handle.id());
 		if (itr == assets.end()) {
 			bloomLog(warning, "Failed to remove asset: Asset does not exist.");
@@ -155,6 +233,7 @@ namespace bloom {
 	
 	/// MARK: - Access
 	Reference<Asset> AssetManager::get(AssetHandle handle) {
+		std::unique_lock lock(_mutex);
 		auto const itr = assets.find(handle.id());
 		if (itr == assets.end()) {
 			bloomLog(error, "Failed to get Asset");
@@ -174,6 +253,7 @@ namespace bloom {
 	}
 	
 	std::string AssetManager::getName(AssetHandle handle) const {
+		std::unique_lock lock(_mutex);
 		if (auto const* asset = find(handle)) {
 			return asset->name;
 		}
@@ -186,6 +266,7 @@ namespace bloom {
 	}
 	
 	std::filesystem::path AssetManager::getRelativeFilepath(AssetHandle handle) const {
+		std::unique_lock lock(_mutex);
 		if (auto const* asset = find(handle)) {
 			return asset->diskLocation;
 		}
@@ -193,6 +274,7 @@ namespace bloom {
 	}
 	
 	void AssetManager::makeAvailable(AssetHandle handle, AssetRepresentation rep, bool force) {
+		std::unique_lock lock(_mutex);
 		auto const itr = assets.find(handle.id());
 		if (itr == assets.end()) {
 			bloomLog(error, "Failed to make available: ID not found [ID = {}]", handle.id());
@@ -208,6 +290,12 @@ namespace bloom {
 		
 		bloomAssert(handle == assetRef->handle());
 		
+		auto const loadable = loadableRepresentation(handle, rep);
+		if (!loadable) {
+			return;
+		}
+		rep = *loadable;
+		
 		try {
 			switch (handle.type()) {
 				case AssetType::staticMesh:
@@ -230,6 +318,10 @@ namespace bloom {
 					makeScriptAvailable(itr->second, rep, force);
 					break;
 					
+				case AssetType::prefab:
+					makePrefabAvailable(itr->second, rep, force);
+					break;
+					
 				default:
 					bloomDebugfail("Unimplemented");
 					break;
@@ -240,27 +332,157 @@ namespace bloom {
 		}
 	}
 	
+	namespace {
+		/// Shared by the worker and the main thread part of a load.
+		struct AsyncLoadState {
+			std::promise<void> promise;
+			utl::function<void()> publish;
+			std::exception_ptr exception;
+			
+			void run(auto&& function) {
+				try {
+					function();
+				}
+				catch (std::exception const& e) {
+					bloomLog(error, "Failed to make Asset Available: {}", e.what());
+					exception = std::current_exception();
+				}
+			}
+		};
+	}
+	
+	std::shared_future<void> AssetManager::makeAvailableAsync(AssetHandle handle, AssetRepresentation rep) {
+		auto const ready = [] {
+			std::promise<void> promise;
+			promise.set_value();
+			return promise.get_future().share();
+		};
+		
+		std::unique_lock lock(_mutex);
+		auto const* const ia = find(handle);
+		if (!ia) {
+			bloomLog(error, "Failed to make available: ID not found [ID = {}]", handle.id());
+			return ready();
+		}
+		if (!ia->theAsset.lock()) {
+			bloomLog(error, "Failed to make available: No references to asset \"{}\"", ia->name);
+			return ready();
+		}
+		
+		auto const loadable = loadableRepresentation(handle, rep);
+		if (!loadable || isAvailable(*ia, *loadable)) {
+			return ready();
+		}
+		rep = *loadable;
+		
+		if (auto const itr = _pendingLoads.find(handle.id()); itr != _pendingLoads.end()) {
+			if ((itr->second.rep | rep) == itr->second.rep) {
+				return itr->second.future;
+			}
+			// The pending load doesn't cover everything, this one supersedes it for later requests.
+			rep |= itr->second.rep;
+		}
+		
+		if (!_jobSystem) {
+			makeAvailable(handle, rep);
+			return ready();
+		}
+		
+		auto state = std::make_shared<AsyncLoadState>();
+		auto future = state->promise.get_future().share();
+		std::size_t const id = ++_loadCounter;
+		_pendingLoads[handle.id()] = PendingLoad{ id, rep, future };
+		++_activeLoads;
+		
+		_jobSystem->submit([this, state, handle, rep, source = makeAbsolute(ia->diskLocation)] {
+			state->run([&]{ state->publish = readAsync(handle, source, rep); });
+		}, [this, state, handle, id, lifetime = std::weak_ptr<int>(_lifetime)] {
+			if (!lifetime.lock()) {
+				state->promise.set_exception(std::make_exception_ptr(std::runtime_error("Asset manager was destroyed while loading")));
+				return;
+			}
+			if (!state->exception) {
+				state->run([&]{ state->publish(); });
+			}
+			finishLoad(handle, id);
+			if (state->exception) {
+				state->promise.set_exception(state->exception);
+			}
+			else {
+				state->promise.set_value();
+			}
+		});
+		return future;
+	}
+	
+	void AssetManager::finishPendingLoads() {
+		if (!_jobSystem) {
+			return;
+		}
+		// Loads may start further loads while reading, e.g. material instances load their material.
+		while (pendingLoadCount() > 0) {
+			_jobSystem->waitIdle();
+			_jobSystem->runMainThreadTasks();
+		}
+	}
+	
+	std::size_t AssetManager::pendingLoadCount() const {
+		std::unique_lock lock(_mutex);
+		return _activeLoads;
+	}
+	
 	bool AssetManager::isValid(AssetHandle handle) const {
+		std::unique_lock lock(_mutex);
 		return !!find(handle);
 	}
 	
+	std::optional<Scene> AssetManager::readScene(AssetHandle handle) {
+		std::filesystem::path source;
+		{
+			std::unique_lock lock(_mutex);
+			auto const* const ia = find(handle);
+			if (!ia || handle.type() != AssetType::scene) {
+				bloomLog(error, "Failed to read scene: ID not found [ID = {}]", handle.id());
+				return std::nullopt;
+			}
+			source = makeAbsolute(ia->diskLocation);
+		}
+		// Parse without holding the lock. Deserializing locks again for every referenced asset.
+		return loadSceneFromDisk(handle, source);
+	}
+	
 	/// MARK: - Save
 	void AssetManager::saveToDisk(AssetHandle handle) {
+		std::unique_lock lock(_mutex);
 		flushToDisk(handle);
 	}
 	
 	void AssetManager::saveAll() {
+		std::unique_lock lock(_mutex);
 		for (auto&& [id, ia]: assets) {
 			saveToDisk(ia.handle);
 		}
 	}
 	
+	void AssetManager::convertScene(AssetHandle handle, FileFormat format) {
+		std::unique_lock lock(_mutex);
+		auto const* const ia = find(handle);
+		if (!ia || handle.type() != AssetType::scene) {
+			bloomLog(error, "Failed to convert scene: ID not found [ID = {}]", handle.id());
+			return;
+		}
+		// Converts the file, unsaved changes of a loaded scene are not written.
+		auto const scene = loadSceneFromDisk(handle, ia->diskLocation);
+		writeSceneToDisk(scene, ia->name, makeAbsolute(ia->diskLocation), format);
+	}
+	
 	/// MARK: - Uncategorized
 	AssetHandle AssetManager::getHandleFromFile(std::filesystem::path path) const {
 		return readHeader(path).handle();
 	}
 	
 	void AssetManager::loadScripts(ScriptEngine& engine) {
+		std::unique_lock lock(_mutex);
 		_scriptClasses.clear();
 		engine.restoreBaseState();
 		for (auto&& [id, internal]: assets) {
@@ -303,18 +525,16 @@ namespace bloom {
 		return &itr->second;
 	}
 	
-	void AssetManager::readAssetMetaData(std::filesystem::path diskLocation, bool forceOverride) {
-		AssetFileHeader const header = readHeader(makeAbsolute(diskLocation));
-		auto const handle = header.handle();
+	void AssetManager::insertAsset(std::filesystem::path diskLocation, AssetHandle handle, std::string name, bool forceOverride) {
 		if (find(handle)) {
 			if (!forceOverride)
 				return;
 		}
 		
+		// The asset itself is allocated by get() once somebody asks for it.
 		auto iAsset = InternalAsset{
-			.theAsset = allocateAsset(handle, header.name()),
-			.name = header.name(),
-			.diskLocation = diskLocation,
+			.name = std::move(name),
+			.diskLocation = std::move(diskLocation),
 			.handle = handle
 		};
 		
@@ -325,11 +545,40 @@ namespace bloom {
 	}
 	
 	/// MARK: - Make Available
+	std::optional<AssetRepresentation> AssetManager::loadableRepresentation(AssetHandle handle, AssetRepresentation rep) const {
+		if (test(rep & AssetRepresentation::GPU) && !application().coreSystems().hasDevice()) {
+			// Running headless. Meshes still load their data, the simulation may need their bounds.
+			if (!test(rep & AssetRepresentation::CPU) && handle.type() != AssetType::staticMesh) {
+				return std::nullopt;
+			}
+			return AssetRepresentation::CPU;
+		}
+		return rep;
+	}
+	
+	bool AssetManager::isAvailable(InternalAsset const& ia, AssetRepresentation rep) const {
+		auto const asset = ia.theAsset.lock();
+		switch (ia.handle.type()) {
+			case AssetType::staticMesh: {
+				auto const& mesh = utl::down_cast<StaticMesh const&>(*asset);
+				return (!test(rep & AssetRepresentation::CPU) || mesh.mData) &&
+					   (!test(rep & AssetRepresentation::GPU) || mesh.mRenderer);
+			}
+			case AssetType::material:
+				return !test(rep & AssetRepresentation::GPU) || (bool)utl::down_cast<Material const&>(*asset).mainPass;
+			
+			default:
+				// Everything else is reloaded like makeAvailable() does.
+				return false;
+		}
+	}
+	
 	void AssetManager::makeStaticMeshAvailable(InternalAsset& ia, AssetRepresentation rep, bool force) {
 		StaticMesh* smAsset = utl::down_cast<StaticMesh*>(ia.theAsset.lock().get());
 		
 		if (test(rep & AssetRepresentation::CPU) && (!smAsset->mData || force)) {
 			smAsset->mData = readStaticMeshFromDisk(ia.diskLocation);
+			smAsset->mBounds = smAsset->mData->calculateBounds();
 		}
 		
 		if (test(rep & AssetRepresentation::GPU) && (!smAsset->mRenderer || force)) {
@@ -395,14 +644,33 @@ namespace bloom {
 		}
 	}
 	
+	void AssetManager::makePrefabAvailable(InternalAsset& ia, AssetRepresentation rep, bool force) {
+		auto ref = ia.theAsset.lock();
+		bloomAssert((bool)ref);
+		Prefab& prefab = utl::down_cast<Prefab&>(*ref);
+		
+		if (test(rep & AssetRepresentation::CPU)) {
+			prefab = loadPrefabFromDisk(ia.handle, ia.diskLocation);
+		}
+		
+		if (test(rep & AssetRepresentation::GPU)) {
+			bloomLog(warning, "No GPU Representation for prefabs");
+		}
+	}
+	
 	///MARK: Disk -> Memory
 	Reference<StaticMeshData> AssetManager::readStaticMeshFromDisk(std::filesystem::path source) {
 		bloomExpect(toExtension(source) == FileExtension::bmesh);
 		source = makeAbsolute(source);
-		std::fstream file(source, std::ios::in | std::ios::binary);
-		handleFileError(file, source);
+		// Vertices and indices are used in place, mapping avoids copying them into the heap before the upload.
+		auto const file = allocateRef<MappedFile const>(source);
+		auto const bytes = file->data();
+		if (bytes.size() < sizeof(AssetFileHeader)) {
+			throw std::runtime_error(utl::format("Mesh file {} is truncated", source));
+		}
 		
-		auto const header = readHeader(file);
+		AssetFileHeader header;
+		std::memcpy(&header, bytes.data(), sizeof(AssetFileHeader));
 		
 		if (header.handle().type() != AssetType::staticMesh) {
 			bloomLog(error, "File was not a Mesh");
@@ -411,14 +679,33 @@ namespace bloom {
 		}
 	
 		auto const meshHeader = header.customDataAs<MeshFileHeader>();
+		std::size_t const vertexOffset = sizeof(AssetFileHeader);
+		std::size_t const indexOffset = vertexOffset + meshHeader.vertexDataSize;
+		if (bytes.size() < indexOffset + meshHeader.indexDataSize) {
+			throw std::runtime_error(utl::format("Mesh file {} is truncated", source));
+		}
+		auto const vertexData = bytes.subspan(vertexOffset, meshHeader.vertexDataSize);
+		auto const indexData = bytes.subspan(indexOffset, meshHeader.indexDataSize);
+		
+		// The mapping is page aligned, so this only fails for a header layout that breaks the alignment of the data.
+		bool const aligned =
+			reinterpret_cast<std::uintptr_t>(vertexData.data()) % alignof(Vertex3D) == 0 &&
+			reinterpret_cast<std::uintptr_t>(indexData.data()) % alignof(std::uint32_t) == 0;
+		if (!aligned) {
+			utl::vector<Vertex3D> vertices;
+			utl::vector<std::uint32_t> indices;
+			vertices.resize(meshHeader.vertexDataSize / sizeof(Vertex3D), utl::no_init);
+			indices.resize(meshHeader.indexDataSize / sizeof(std::uint32_t), utl::no_init);
+			std::memcpy(vertices.data(), vertexData.data(), vertices.size() * sizeof(Vertex3D));
+			std::memcpy(indices.data(), indexData.data(), indices.size() * sizeof(std::uint32_t));
+			return allocateRef<StaticMeshData>(std::move(vertices), std::move(indices));
+		}
 		
-		auto const result = allocateRef<StaticMeshData>();
-		result->vertices.resize(meshHeader.vertexDataSize / sizeof(Vertex3D), utl::no_init);
-		result->indices.resize(meshHeader.indexDataSize  / sizeof(uint32_t), utl::no_init);
-		file.read((char*)result->vertices.data(), meshHeader.vertexDataSize);
-		file.read((char*)result->indices.data(),  meshHeader.indexDataSize);
-		
-		return result;
+		return allocateRef<StaticMeshData>(file,
+										   std::span(reinterpret_cast<Vertex3D const*>(vertexData.data()),
+													 meshHeader.vertexDataSize / sizeof(Vertex3D)),
+										   std::span(reinterpret_cast<std::uint32_t const*>(indexData.data()),
+													 meshHeader.indexDataSize / sizeof(std::uint32_t)));
 	}
 	
 	MaterialInstance AssetManager::loadMaterialInstanceFromDisk(AssetHandle handle, std::filesystem::path source) {
@@ -464,15 +751,51 @@ namespace bloom {
 		auto const sceneHeader = header.customDataAs<SceneFileHeader>();
 		(void)sceneHeader;
 		
-		std::stringstream sstr;
-		sstr << file.rdbuf();
-		YAML::Node root = YAML::Load(sstr.str());
 		Scene scene(handle, header.name());
+		if (header.format() == FileFormat::binary) {
+			scene.deserializeBinary(file, *this);
+			return scene;
+		}
+		auto const begin = file.tellg();
+		if (scene.deserialize(file, *this)) {
+			return scene;
+		}
+		bloomLog(info, "Scene \"{}\" is read as a whole, saving it again lets it be streamed", header.name());
+		file.clear();
+		file.seekg(begin);
+		scene = Scene(handle, header.name());
+		YAML::Node root = YAML::Load(file);
 		scene.deserialize(root, *this);
 		
 		return scene;
 	}
 	
+	Prefab AssetManager::loadPrefabFromDisk(AssetHandle handle, std::filesystem::path source) {
+		bloomExpect(toExtension(source) == FileExtension::bprefab);
+		source = makeAbsolute(source);
+		std::fstream file(source, std::ios::in | std::ios::binary);
+		handleFileError(file, source);
+		
+		auto const header = readHeader(file);
+		
+		if (header.handle().type() != AssetType::prefab) {
+			bloomLog(error, "File was not a Prefab");
+			bloomDebugbreak();
+			return Prefab(handle, header.name());
+		}
+		
+		auto const prefabHeader = header.customDataAs<PrefabFileHeader>();
+		(void)prefabHeader;
+		
+		std::stringstream sstr;
+		sstr << file.rdbuf();
+		YAML::Node root = YAML::Load(sstr.str());
+		Prefab prefab(handle, header.name());
+		prefab.deserialize(root, *this);
+		
+		return prefab;
+	}
+	
 	std::string AssetManager::loadTextFromDisk(std::filesystem::path source) {
 		bloomExpect(toExtension(source) == FileExtension::chai);
 		source = makeAbsolute(source);
@@ -494,20 +817,84 @@ namespace bloom {
 		if (!smData) {
 			smData = readStaticMeshFromDisk(ia.diskLocation);
 		}
-		
-		asset->mRenderer = allocateRef<StaticMeshRenderer>();
-		auto* const mesh = asset->mRenderer.get();
+		if (!asset->mBounds) {
+			asset->mBounds = smData->calculateBounds();
+		}
+		loadStaticMeshRenderer(*asset, *smData);
+	}
+	
+	void AssetManager::loadStaticMeshRenderer(StaticMesh& asset, StaticMeshData const& data) {
+		asset.mRenderer = allocateRef<StaticMeshRenderer>();
+		auto* const mesh = asset.mRenderer.get();
 		
 		BufferDescription desc;
-		desc.data = smData->vertices.data();
-		desc.size = smData->vertices.size() * sizeof(smData->vertices[0]);
+		// Mapped data is uploaded straight from the page cache.
+		desc.data = data.vertices().data();
+		desc.size = data.vertices().size_bytes();
 		desc.storageMode = StorageMode::shared;
 		mesh->mVertexBuffer = device().createBuffer(desc);
-		desc.data = smData->indices.data();
-		desc.size = smData->indices.size() * 4;
+		desc.data = data.indices().data();
+		desc.size = data.indices().size_bytes();
 		mesh->mIndexBuffer = device().createBuffer(desc);
 	}
 	
+	/// MARK: - Async
+	utl::function<void()> AssetManager::readAsync(AssetHandle handle, std::filesystem::path source, AssetRepresentation rep) {
+		// Publishing locks and looks the asset up again, it may have been removed or released in the meantime.
+		auto publish = [this, handle](auto assign) -> utl::function<void()> {
+			return [this, handle, assign = std::move(assign)]{
+				std::unique_lock lock(_mutex);
+				auto* const ia = find(handle);
+				if (auto const asset = ia ? ia->theAsset.lock() : nullptr) {
+					assign(*asset);
+				}
+			};
+		};
+		switch (handle.type()) {
+			case AssetType::staticMesh: {
+				auto const data = readStaticMeshFromDisk(source);
+				auto const bounds = data->calculateBounds();
+				return publish([this, data, bounds, rep](Asset& asset) {
+					auto& mesh = utl::down_cast<StaticMesh&>(asset);
+					if (test(rep & AssetRepresentation::CPU)) {
+						mesh.mData = data;
+						mesh.mBounds = bounds;
+					}
+					else if (!mesh.mBounds) {
+						mesh.mBounds = bounds;
+					}
+					if (test(rep & AssetRepresentation::GPU) && !mesh.mRenderer) {
+						loadStaticMeshRenderer(mesh, *data);
+					}
+				});
+			}
+			case AssetType::materialInstance: {
+				auto loaded = std::make_shared<MaterialInstance>(loadMaterialInstanceFromDisk(handle, source));
+				return publish([loaded](Asset& asset) { utl::down_cast<MaterialInstance&>(asset) = std::move(*loaded); });
+			}
+			case AssetType::scene: {
+				auto loaded = std::make_shared<Scene>(loadSceneFromDisk(handle, source));
+				return publish([loaded](Asset& asset) { utl::down_cast<Scene&>(asset) = std::move(*loaded); });
+			}
+			case AssetType::prefab: {
+				auto loaded = std::make_shared<Prefab>(loadPrefabFromDisk(handle, source));
+				return publish([loaded](Asset& asset) { utl::down_cast<Prefab&>(asset) = std::move(*loaded); });
+			}
+			default:
+				// Nothing worth reading ahead, materials are built on the GPU and scripts are tiny.
+				return [this, handle, rep]{ makeAvailable(handle, rep); };
+		}
+	}
+	
+	void AssetManager::finishLoad(AssetHandle handle, std::size_t id) {
+		std::unique_lock lock(_mutex);
+		--_activeLoads;
+		auto const itr = _pendingLoads.find(handle.id());
+		if (itr != _pendingLoads.end() && itr->second.id == id) {
+			_pendingLoads.erase(itr);
+		}
+	}
+	
 	
 	/// MARK: - Memory -> Disk
 	void AssetManager::flushToDisk(AssetHandle handle) {
@@ -527,6 +914,9 @@ namespace bloom {
 			case AssetType::script:
 				flushScriptToDisk(handle);
 				break;
+			case AssetType::prefab:
+				flushPrefabToDisk(handle);
+				break;
 				
 			default:
 				bloomDebugbreak();
@@ -552,8 +942,8 @@ namespace bloom {
 			return;
 		}
 		
-		std::uint64_t const vertexDataSize = mesh.vertices.size() * sizeof(bloom::Vertex3D);
-		std::uint64_t const indexDataSize = mesh.indices.size() * sizeof(uint32_t);
+		std::uint64_t const vertexDataSize = mesh.vertices().size() * sizeof(bloom::Vertex3D);
+		std::uint64_t const indexDataSize = mesh.indices().size() * sizeof(uint32_t);
 		
 		// make header
 		AssetFileHeader const header(handle, FileFormat::binary, asset->name, MeshFileHeader{
@@ -563,13 +953,19 @@ namespace bloom {
 		
 		std::ios::sync_with_stdio(false);
 		
+		// The mesh may be mapped from the file it is written to. Truncating a mapped file invalidates the mapping,
+		// so write next to it and replace it instead. Mappings of the old file stay valid.
 		auto const dest = makeAbsolute(asset->diskLocation);
-		std::fstream file(dest, std::ios::out | std::ios::trunc | std::ios::binary);
-		handleFileError(file, dest);
-		
-		file.write((char*)&header, sizeof(AssetFileHeader));
-		file.write((char*)mesh.vertices.data(), vertexDataSize);
-		file.write((char*)mesh.indices.data(), indexDataSize);
+		auto const temporary = std::filesystem::path(dest).concat(".tmp");
+		{
+			std::fstream file(temporary, std::ios::out | std::ios::trunc | std::ios::binary);
+			handleFileError(file, temporary);
+			
+			file.write((char*)&header, sizeof(AssetFileHeader));
+			file.write((char*)mesh.vertices().data(), vertexDataSize);
+			file.write((char*)mesh.indices().data(), indexDataSize);
+		}
+		std::filesystem::rename(temporary, dest);
 	}
 	
 	void AssetManager::flushMaterialToDisk(AssetHandle handle) {
@@ -630,21 +1026,55 @@ namespace bloom {
 		
 		auto const& scene = utl::down_cast<Scene const&>(*asset);
 		
+		// Scenes keep the format they are stored in, convertScene() switches it.
+		auto const dest = makeAbsolute(ia->diskLocation);
+		FileFormat const format = std::filesystem::exists(dest) ? readHeader(dest).format() : FileFormat::text;
+		writeSceneToDisk(scene, ia->name, dest, format);
+	}
+	
+	void AssetManager::writeSceneToDisk(Scene const& scene, std::string_view name, std::filesystem::path const& dest, FileFormat format) {
 		// make header
-		AssetFileHeader const header(handle, FileFormat::text, ia->name, SceneFileHeader{});
+		AssetFileHeader const header(scene.handle(), format, name, SceneFileHeader{});
 		
 		std::ios::sync_with_stdio(false);
 		
-		auto const dest = makeAbsolute(ia->diskLocation);
 		std::fstream file(dest, std::ios::out | std::ios::trunc | std::ios::binary);
 		handleFileError(file, dest);
 		
 		file.write((char*)&header, sizeof(AssetFileHeader));
+		if (format == FileFormat::binary) {
+			scene.serializeBinary(file);
+			return;
+		}
 		YAML::Emitter out;
 		out << scene.serialize();
 		file << out.c_str();
 	}
 	
+	void AssetManager::flushPrefabToDisk(AssetHandle handle) {
+		InternalAsset const* const ia = find(handle);
+		bloomAssert(ia);
+		auto const asset = ia->theAsset.lock();
+		bloomAssert(!!asset);
+		bloomAssert(asset->handle() == handle);
+		
+		auto const& prefab = utl::down_cast<Prefab const&>(*asset);
+		
+		// make header
+		AssetFileHeader const header(handle, FileFormat::text, ia->name, PrefabFileHeader{});
+		
+		std::ios::sync_with_stdio(false);
+		
+		auto const dest = makeAbsolute(ia->diskLocation);
+		std::fstream file(dest, std::ios::out | std::ios::trunc | std::ios::binary);
+		handleFileError(file, dest);
+		
+		file.write((char*)&header, sizeof(AssetFileHeader));
+		YAML::Emitter out;
+		out << prefab.serialize();
+		file << out.c_str();
+	}
+	
 	void AssetManager::flushScriptToDisk(AssetHandle handle) {
 		auto const* const asset = find(handle);
 		bloomAssert(asset);
@@ -680,9 +1110,29 @@ namespace bloom {
 		// import
 		MeshImporter importer;
 		meshOut->mData = allocateRef<StaticMeshData>(importer.import(source));
+		meshOut->mBounds = meshOut->mData->calculateBounds();
 	}
 
 	/// MARK: - File Handling
+	void AssetManager::writeRegistry() const {
+		auto const dest = _workingDir / AssetRegistry::fileName;
+		auto tmp = dest;
+		tmp += ".tmp";
+		{
+			std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+			_registry.write(file);
+			if (!file) {
+				bloomLog(warning, "Failed to write asset registry {}", dest);
+				return;
+			}
+		}
+		std::error_code error;
+		std::filesystem::rename(tmp, dest, error);
+		if (error) {
+			bloomLog(warning, "Failed to write asset registry {}: {}", dest, error.message());
+		}
+	}
+	
 	std::filesystem::path AssetManager::makeRelative(std::filesystem::path const& path) const {
 		if (path.is_absolute()) {
 			return std::filesystem::relative(path, workingDir());
@@ -2,30 +2,37 @@
 
 #include "Asset.hpp"
 #include "AssetFileHeader.hpp"
+#include "AssetRegistry.hpp"
 
 #include "Bloom/Core/Core.hpp"
 #include "Bloom/Application/CoreSystem.hpp"
 #include "Bloom/Scene/Scene.hpp"
+#include "Bloom/Scene/Prefab.hpp"
 #include "Bloom/Graphics/Material/Material.hpp"
 #include "Bloom/Graphics/Material/MaterialInstance.hpp"
 
 #include <filesystem>
+#include <utl/functional.hpp>
 #include <utl/vector.hpp>
 #include <utl/hashmap.hpp>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <span>
 
 namespace bloom {
 	
 	class HardwareDevice;
+	class JobSystem;
 	class StaticMeshData;
 	class StaticMesh;
 	class ScriptEngine;
 	
 	class BLOOM_API AssetManager: public CoreSystem {
 	public:
-		AssetManager() = default;
+		/// @param jobSystem	Runs the loads started by \p makeAvailableAsync(). Without one they complete right away.
+		explicit AssetManager(JobSystem* jobSystem = nullptr);
 		virtual ~AssetManager();
 		
 		/// MARK: Environment
@@ -99,6 +106,27 @@ namespace bloom {
 		/// @param force	If true, reloads asset into memory even if already available.
 		void makeAvailable(AssetHandle handle, AssetRepresentation rep, bool force = false);
 		
+		/// @brief 			Loads an asset like \p makeAvailable() without blocking. Thread safe.
+		/// 				Reading and parsing run on the job system. Publishing the asset and uploading it to the GPU
+		/// 				run on the main thread during \p JobSystem::runMainThreadTasks().
+		/// 				Requests for an asset that is already loading share that load if it covers \p rep.
+		/// @returns		Future that becomes ready once the asset is available and holds the exception if loading failed.
+		/// 				Don't wait on it on the main thread, that would never run the upload. Use \p finishPendingLoads() there.
+		std::shared_future<void> makeAvailableAsync(AssetHandle handle, AssetRepresentation rep);
+		
+		/// @brief 	Returns once all loads started by \p makeAvailableAsync() have completed, including the loads they started.
+		/// 		Main thread only, runs the main thread tasks of the job system.
+		void finishPendingLoads();
+		
+		/// @returns Number of loads started by \p makeAvailableAsync() that have not completed.
+		std::size_t pendingLoadCount() const;
+		
+		/// @brief 			Reads a scene from disk into a new object, leaving the scene asset untouched.
+		/// 				Safe to call from any thread, used to stream scenes in the background.
+		/// @param handle 	Handle to a scene asset.
+		/// @returns		The scene, or nothing if \p handle is not a scene. Throws if the file cannot be read.
+		std::optional<Scene> readScene(AssetHandle handle);
+		
 		/// @brief 		Check if an AssetHandle is valid.
 		/// @param 		handle Handle to an asset.
 		/// @returns	true iff Handle points to an asset stored in current working directory.
@@ -111,6 +139,11 @@ namespace bloom {
 		
 		void saveAll();
 		
+		/// @brief			Rewrites a scene file in \p format. Binary scenes load faster, text scenes can be diffed and merged.
+		/// 				The scene is saved in that format from then on.
+		/// @param handle	Handle to a scene asset.
+		void convertScene(AssetHandle handle, FileFormat format);
+		
 		
 		/// MARK: Uncategorized
 		// path can be relative or absolute
@@ -131,24 +164,41 @@ namespace bloom {
 		InternalAsset* find(AssetHandle);
 		InternalAsset const* find(AssetHandle) const;
 		
-		void readAssetMetaData(std::filesystem::path diskLocation, bool forceOverride = false);
+		void insertAsset(std::filesystem::path diskLocation, AssetHandle, std::string name, bool forceOverride);
 		
 		/// MARK: Make Available
+		/// Representation that can be loaded in this environment. Nothing if there is nothing to load.
+		std::optional<AssetRepresentation> loadableRepresentation(AssetHandle, AssetRepresentation rep) const;
+		bool isAvailable(InternalAsset const&, AssetRepresentation rep) const;
 		void makeStaticMeshAvailable(InternalAsset&, AssetRepresentation rep, bool force);
 		void makeMaterialAvailable(InternalAsset&, AssetRepresentation rep, bool force);
 		void makeMaterialInstanceAvailable(InternalAsset&, AssetRepresentation rep, bool force);
 		void makeSceneAvailable(InternalAsset&, AssetRepresentation rep, bool force);
 		void makeScriptAvailable(InternalAsset&, AssetRepresentation rep, bool force);
+		void makePrefabAvailable(InternalAsset&, AssetRepresentation rep, bool force);
 		
 		
 		///MARK: Disk -> Memory
 		Reference<StaticMeshData> readStaticMeshFromDisk(std::filesystem::path source);
 		MaterialInstance loadMaterialInstanceFromDisk(AssetHandle, std::filesystem::path source);
 		Scene loadSceneFromDisk(AssetHandle, std::filesystem::path source);
+		Prefab loadPrefabFromDisk(AssetHandle, std::filesystem::path source);
 		std::string loadTextFromDisk(std::filesystem::path source);
 		
 		/// MARK: Memory -> GPU
 		void loadStaticMeshRenderer(InternalAsset&);
+		void loadStaticMeshRenderer(StaticMesh&, StaticMeshData const&);
+		
+		/// MARK: Async
+		struct PendingLoad {
+			std::size_t id;
+			AssetRepresentation rep;
+			std::shared_future<void> future;
+		};
+		
+		/// Reads the asset on the calling thread. Returns the function that publishes it on the main thread.
+		utl::function<void()> readAsync(AssetHandle, std::filesystem::path diskLocation, AssetRepresentation rep);
+		void finishLoad(AssetHandle, std::size_t id);
 		
 		/// MARK: Memory -> Disk
 		void flushToDisk(AssetHandle);
@@ -156,7 +206,9 @@ namespace bloom {
 		void flushMaterialToDisk(AssetHandle);
 		void flushMaterialInstanceToDisk(AssetHandle);
 		void flushSceneToDisk(AssetHandle);
+		void writeSceneToDisk(Scene const&, std::string_view name, std::filesystem::path const& dest, FileFormat);
 		void flushScriptToDisk(AssetHandle);
+		void flushPrefabToDisk(AssetHandle);
 		
 		
 		/// MARK: Import
@@ -170,13 +222,25 @@ namespace bloom {
 		[[ nodiscard ]] std::filesystem::path makeAbsolute(std::filesystem::path const&) const;
 		AssetFileHeader readHeader(std::filesystem::path) const;
 		AssetFileHeader readHeader(std::fstream&) const;
+		/// Saves the registry so the next refresh can skip unchanged files.
+		void writeRegistry() const;
 		void handleFileError(std::fstream&, std::filesystem::path const&) const;
 		
 		
 	private:
+		/// Public functions lock, so assets can be loaded from worker threads. Recursive since loading an asset loads its dependencies.
+		mutable std::recursive_mutex _mutex;
 		utl::hashmap<utl::UUID, InternalAsset> assets;
 		std::filesystem::path _workingDir;
 		utl::vector<std::string> _scriptClasses;
+		AssetRegistry _registry;
+		
+		JobSystem* _jobSystem = nullptr;
+		utl::hashmap<utl::UUID, PendingLoad> _pendingLoads;
+		std::size_t _loadCounter = 0;
+		std::size_t _activeLoads = 0;
+		/// Main thread continuations of loads check this, they may run after the manager is gone.
+		std::shared_ptr<int> _lifetime = std::make_shared<int>();
 	};
 
 	
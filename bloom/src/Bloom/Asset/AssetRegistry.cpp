@@ -0,0 +1,101 @@
+#include "AssetRegistry.hpp"
+
+#include "Bloom/Core/Debug.hpp"
+
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace bloom {
+	
+	/// MARK: Format
+	static constexpr std::uint32_t registryMagic = 0x47455242; // "BREG"
+	static constexpr std::uint32_t registryVersion = 1;
+	
+	template <typename T>
+	static void writeValue(std::ostream& stream, T const& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		stream.write(reinterpret_cast<char const*>(&value), sizeof value);
+	}
+	
+	static void writeString(std::ostream& stream, std::string_view string) {
+		writeValue(stream, static_cast<std::uint32_t>(string.size()));
+		stream.write(string.data(), string.size());
+	}
+	
+	template <typename T>
+	static T readValue(std::istream& stream) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		T value;
+		stream.read(reinterpret_cast<char*>(&value), sizeof value);
+		if (!stream) {
+			throw std::runtime_error("Asset registry is truncated");
+		}
+		return value;
+	}
+	
+	static std::string readString(std::istream& stream) {
+		auto const size = readValue<std::uint32_t>(stream);
+		if (size > 4096) {
+			throw std::runtime_error("Asset registry is corrupted");
+		}
+		std::string result(size, '\0');
+		stream.read(result.data(), result.size());
+		if (!stream) {
+			throw std::runtime_error("Asset registry is truncated");
+		}
+		return result;
+	}
+	
+	/// MARK: AssetRegistry
+	AssetRegistryEntry const* AssetRegistry::find(std::string const& path, std::int64_t modificationTime, std::uint64_t size) const {
+		auto const itr = mEntries.find(path);
+		if (itr == mEntries.end() || itr->second.modificationTime != modificationTime || itr->second.size != size) {
+			return nullptr;
+		}
+		return &itr->second;
+	}
+	
+	void AssetRegistry::insert(std::string path, AssetRegistryEntry entry) {
+		mEntries[std::move(path)] = std::move(entry);
+	}
+	
+	void AssetRegistry::read(std::istream& stream) {
+		mEntries.clear();
+		try {
+			if (readValue<std::uint32_t>(stream) != registryMagic || readValue<std::uint32_t>(stream) != registryVersion) {
+				return;
+			}
+			auto const count = readValue<std::uint64_t>(stream);
+			for (std::uint64_t i = 0; i < count; ++i) {
+				auto path = readString(stream);
+				AssetRegistryEntry entry;
+				entry.modificationTime = readValue<std::int64_t>(stream);
+				entry.size = readValue<std::uint64_t>(stream);
+				entry.handle = readValue<AssetHandle>(stream);
+				entry.name = readString(stream);
+				mEntries.insert({ std::move(path), std::move(entry) });
+			}
+		}
+		catch (std::exception const& e) {
+			// A stale cache only costs a full scan.
+			bloomLog(warning, "Discarding asset registry: {}", e.what());
+			mEntries.clear();
+		}
+	}
+	
+	void AssetRegistry::write(std::ostream& stream) const {
+		writeValue(stream, registryMagic);
+		writeValue(stream, registryVersion);
+		writeValue(stream, static_cast<std::uint64_t>(mEntries.size()));
+		for (auto const& [path, entry]: mEntries) {
+			writeString(stream, path);
+			writeValue(stream, entry.modificationTime);
+			writeValue(stream, entry.size);
+			writeValue(stream, entry.handle);
+			writeString(stream, entry.name);
+		}
+	}
+	
+}
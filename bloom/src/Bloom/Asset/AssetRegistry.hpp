@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Asset.hpp"
+
+#include "Bloom/Core/Base.hpp"
+
+#include <utl/hashmap.hpp>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace bloom {
+	
+	/// What the asset manager read from the header of a file in the working directory.
+	struct AssetRegistryEntry {
+		/// Modification time and size of the file when the header was read.
+		std::int64_t modificationTime = 0;
+		std::uint64_t size = 0;
+		AssetHandle handle;
+		std::string name;
+	};
+	
+	/// Persistent cache of the asset headers of a project, so refreshing only opens files that changed.
+	/// Keyed by path relative to the working directory.
+	class BLOOM_API AssetRegistry {
+	public:
+		/// Name of the cache file in the working directory. Hidden, so the scan skips it.
+		static constexpr std::string_view fileName = ".AssetRegistry";
+		
+		/// Returns the entry of \p path if the file still has the same modification time and size, otherwise null.
+		AssetRegistryEntry const* find(std::string const& path, std::int64_t modificationTime, std::uint64_t size) const;
+		
+		void insert(std::string path, AssetRegistryEntry entry);
+		void clear() { mEntries.clear(); }
+		std::size_t size() const { return mEntries.size(); }
+		
+		/// Replaces the entries with the ones in \p stream. Leaves the registry empty if the stream is not a cache of this version.
+		void read(std::istream& stream);
+		void write(std::ostream& stream) const;
+	
+	private:
+		utl::hashmap<std::string, AssetRegistryEntry> mEntries;
+	};
+	
+}
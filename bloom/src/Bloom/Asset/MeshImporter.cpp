@@ -39,7 +39,8 @@ namespace bloom {
 			bloomAssert(scene->mNumMeshes);
 			
 			auto* const mesh = scene->mMeshes[0];
-			bloom::StaticMeshData result;
+			utl::vector<Vertex3D> vertices;
+			utl::vector<std::uint32_t> indices;
 			
 			auto* const position = mesh->mVertices;
 			bloomAssert(position);
@@ -54,10 +55,10 @@ namespace bloom {
 			};
 			{
 				std::size_t const vertexCount = mesh->mNumVertices;
-				result.vertices.resize(vertexCount);
+				vertices.resize(vertexCount);
 				
 				for (std::size_t i = 0; i < vertexCount; ++i) {
-					auto& v = result.vertices[i];
+					auto& v = vertices[i];
 					if (position)
 						v.position = baseWorldScale() * mtl::float3{ position[i].x, position[i].y, position[i].z };
 					if (normal)
@@ -75,16 +76,16 @@ namespace bloom {
 			{
 				std::size_t const faceCount = mesh->mNumFaces;
 				std::size_t const indexCount = faceCount * 3;
-				result.indices.resize(indexCount);
+				indices.resize(indexCount);
 				auto* const face = mesh->mFaces;
 				for (std::size_t i = 0, k = 0; i < faceCount; ++i) {
 					bloomAssert(face[i].mNumIndices == 3);
 					for (std::size_t j = 0; j < 3; ++j, ++k) {
-						result.indices[k] = face[i].mIndices[j];
+						indices[k] = face[i].mIndices[j];
 					}
 				}
 			}
-			return result;
+			return bloom::StaticMeshData(std::move(vertices), std::move(indices));
 		}
 	}
 	
@@ -1,6 +1,6 @@
 #include "Bloom/Core/Base.hpp"
 
-#ifdef BLOOM_PLATFORM_APPLE
+#if defined(BLOOM_PLATFORM_APPLE) && !defined(BLOOM_HEADLESS) // Autorelease.mm is not built headless
 
 #define BLOOM_AUTORELEASE_BEGIN ::bloom::autoreleased([&]{
 #define BLOOM_AUTORELEASE_END   });
@@ -13,7 +13,7 @@
 
 #endif
 
-#ifdef BLOOM_PLATFORM_APPLE
+#if defined(BLOOM_PLATFORM_APPLE) && !defined(BLOOM_HEADLESS)
 
 #include <utl/functional.hpp>
 
@@ -0,0 +1,127 @@
+#include "Geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace bloom {
+	
+	float AABB::surfaceArea() const {
+		mtl::float3 const size = upper - lower;
+		return 2 * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+	
+	bool AABB::contains(AABB const& other) const {
+		for (int i = 0; i < 3; ++i) {
+			if (other.lower[i] < lower[i] || other.upper[i] > upper[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+	
+	AABB AABB::expanded(float margin) const {
+		return { lower - margin, upper + margin };
+	}
+	
+	AABB merge(AABB const& a, AABB const& b) {
+		return { mtl::min(a.lower, b.lower), mtl::max(a.upper, b.upper) };
+	}
+	
+	AABB transform(AABB const& box, mtl::float4x4 const& matrix) {
+		mtl::float3 const center = (matrix * mtl::float4(box.center(), 1)).xyz;
+		mtl::float3 const extent = box.extent();
+		mtl::float3 newExtent = 0;
+		for (int r = 0; r < 3; ++r) {
+			for (int c = 0; c < 3; ++c) {
+				newExtent[r] += std::abs(matrix.column(c)[r]) * extent[c];
+			}
+		}
+		return { center - newExtent, center + newExtent };
+	}
+	
+	/// MARK: Frustum
+	Frustum::Frustum(mtl::float4x4 const& viewProjection) {
+		auto row = [&](int r) {
+			return mtl::float4(viewProjection.column(0)[r],
+							   viewProjection.column(1)[r],
+							   viewProjection.column(2)[r],
+							   viewProjection.column(3)[r]);
+		};
+		mtl::float4 const x = row(0), y = row(1), z = row(2), w = row(3);
+		// The near plane w + z is exact for a [-1, 1] depth range and conservative for [0, 1].
+		for (mtl::float4 const p: { w + x, w - x, w + y, w - y, w + z, w - z }) {
+			float const length = mtl::norm(p.xyz);
+			if (length < 1e-6f) {
+				continue;
+			}
+			mPlanes[mPlaneCount++] = { p.xyz / length, p.w / length };
+		}
+	}
+	
+	Containment Frustum::classify(AABB const& box) const {
+		Containment result = Containment::inside;
+		for (Plane const& plane: planes()) {
+			mtl::float3 positive = box.lower, negative = box.upper;
+			for (int i = 0; i < 3; ++i) {
+				if (plane.normal[i] >= 0) {
+					std::swap(positive[i], negative[i]);
+				}
+			}
+			if (mtl::dot(plane.normal, positive) + plane.distance < 0) {
+				return Containment::outside;
+			}
+			if (mtl::dot(plane.normal, negative) + plane.distance < 0) {
+				result = Containment::intersecting;
+			}
+		}
+		return result;
+	}
+	
+	/// MARK: Intersection
+	bool intersects(AABB const& a, AABB const& b) {
+		for (int i = 0; i < 3; ++i) {
+			if (a.upper[i] < b.lower[i] || b.upper[i] < a.lower[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+	
+	bool intersects(AABB const& box, Sphere const& sphere) {
+		mtl::float3 const closest = mtl::max(box.lower, mtl::min(sphere.center, box.upper));
+		mtl::float3 const d = closest - sphere.center;
+		return mtl::dot(d, d) <= sphere.radius * sphere.radius;
+	}
+	
+	bool intersects(Frustum const& frustum, AABB const& box) {
+		return frustum.classify(box) != Containment::outside;
+	}
+	
+	std::optional<float> intersect(Ray const& ray, AABB const& box, float maxDistance) {
+		float tmin = 0, tmax = maxDistance;
+		for (int i = 0; i < 3; ++i) {
+			if (std::abs(ray.direction[i]) < std::numeric_limits<float>::min()) {
+				// Parallel to the slab, hit only if the origin lies within it.
+				if (ray.origin[i] < box.lower[i] || ray.origin[i] > box.upper[i]) {
+					return std::nullopt;
+				}
+				continue;
+			}
+			float const inverse = 1 / ray.direction[i];
+			float t0 = (box.lower[i] - ray.origin[i]) * inverse;
+			float t1 = (box.upper[i] - ray.origin[i]) * inverse;
+			if (t0 > t1) {
+				std::swap(t0, t1);
+			}
+			tmin = std::max(tmin, t0);
+			tmax = std::min(tmax, t1);
+			if (tmin > tmax) {
+				return std::nullopt;
+			}
+		}
+		return tmin;
+	}
+	
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include <mtl/mtl.hpp>
+#include <array>
+#include <optional>
+#include <span>
+
+namespace bloom {
+	
+	/// Axis aligned bounding box.
+	struct BLOOM_API AABB {
+		mtl::float3 lower = 0, upper = 0;
+		
+		mtl::float3 center() const { return (lower + upper) / 2; }
+		/// Half the size along each axis.
+		mtl::float3 extent() const { return (upper - lower) / 2; }
+		
+		float surfaceArea() const;
+		
+		bool contains(AABB const& other) const;
+		
+		/// Grows the box by \p margin in every direction.
+		AABB expanded(float margin) const;
+	};
+	
+	/// Smallest box containing both \p a and \p b.
+	BLOOM_API AABB merge(AABB const& a, AABB const& b);
+	
+	/// Bounding box of \p box after transforming it by \p matrix.
+	BLOOM_API AABB transform(AABB const& box, mtl::float4x4 const& matrix);
+	
+	struct BLOOM_API Sphere {
+		mtl::float3 center = 0;
+		float radius = 0;
+	};
+	
+	struct BLOOM_API Ray {
+		mtl::float3 origin = 0;
+		/// Must be normalized.
+		mtl::float3 direction = { 1, 0, 0 };
+	};
+	
+	/// Points \p p with \p dot(normal, p) + \p distance >= 0 are in front of the plane.
+	struct BLOOM_API Plane {
+		mtl::float3 normal = { 0, 0, 1 };
+		float distance = 0;
+	};
+	
+	enum class Containment {
+		outside, intersecting, inside
+	};
+	
+	/// Convex volume bounded by the clip planes of a view projection matrix.
+	class BLOOM_API Frustum {
+	public:
+		Frustum() = default;
+		/// Extracts the planes of \p viewProjection. Degenerate planes, like the far plane of an infinite projection, are dropped.
+		explicit Frustum(mtl::float4x4 const& viewProjection);
+		
+		std::span<Plane const> planes() const { return { mPlanes.data(), mPlaneCount }; }
+		
+		Containment classify(AABB const&) const;
+	
+	private:
+		std::array<Plane, 6> mPlanes;
+		std::size_t mPlaneCount = 0;
+	};
+	
+	BLOOM_API bool intersects(AABB const& a, AABB const& b);
+	BLOOM_API bool intersects(AABB const&, Sphere const&);
+	BLOOM_API bool intersects(Frustum const&, AABB const&);
+	
+	/// Distance along \p ray at which it enters \p box, if that happens within [0, \p maxDistance].
+	/// Returns zero if the origin lies inside of \p box.
+	BLOOM_API std::optional<float> intersect(Ray const& ray, AABB const& box, float maxDistance);
+	
+}
@@ -0,0 +1,185 @@
+#include "InternedString.hpp"
+
+#include <utl/hashmap.hpp>
+#include <utl/vector.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace bloom {
+	
+	/// Identifiers are never reused, unlike addresses, so an entry never appears to belong to a newer table.
+	static std::atomic_uint64_t nextTableID = 1;
+	
+	struct InternedString::Entry {
+		std::string const string;
+		/// Zero for strings that are not part of a table.
+		std::uint64_t const tableID = 0;
+		/// Slot in the table, used to resolve handles into the table a copy was made from.
+		std::uint32_t const index = 0;
+		/// The table holds one reference to each of its entries.
+		std::atomic_uint32_t references = 1;
+		
+		void retain() {
+			references.fetch_add(1, std::memory_order_relaxed);
+		}
+		
+		void release() {
+			if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				delete this;
+			}
+		}
+	};
+	
+	/// MARK: InternedString
+	InternedString::InternedString(std::string_view string) {
+		if (!string.empty()) {
+			mEntry = new Entry{ std::string(string) };
+		}
+	}
+	
+	InternedString::InternedString(InternedString const& rhs): mEntry(rhs.mEntry) {
+		if (mEntry) {
+			mEntry->retain();
+		}
+	}
+	
+	InternedString& InternedString::operator=(InternedString const& rhs) {
+		InternedString copy(rhs);
+		std::swap(mEntry, copy.mEntry);
+		return *this;
+	}
+	
+	InternedString& InternedString::operator=(InternedString&& rhs) noexcept {
+		InternedString moved(std::move(rhs));
+		std::swap(mEntry, moved.mEntry);
+		return *this;
+	}
+	
+	InternedString::~InternedString() {
+		if (mEntry) {
+			mEntry->release();
+		}
+	}
+	
+	std::string_view InternedString::view() const {
+		return mEntry ? std::string_view(mEntry->string) : std::string_view();
+	}
+	
+	char const* InternedString::c_str() const {
+		return mEntry ? mEntry->string.c_str() : "";
+	}
+	
+	/// MARK: StringTable
+	struct StringTable::State {
+		using Entry = InternedString::Entry;
+		
+		~State() {
+			for (Entry* entry: entries) {
+				if (entry) {
+					entry->release();
+				}
+			}
+		}
+		
+		InternedString handle(Entry* entry) const {
+			entry->retain();
+			return InternedString(entry);
+		}
+		
+		std::uint64_t id = nextTableID.fetch_add(1, std::memory_order_relaxed);
+		/// Entries by index, null for free slots.
+		utl::vector<Entry*> entries;
+		utl::vector<std::uint32_t> freeSlots;
+		/// Keys view the strings of the entries.
+		utl::hashmap<std::string_view, Entry*> lookup;
+		std::size_t sweepThreshold = 64;
+	};
+	
+	StringTable::StringTable(): mState(std::make_unique<State>()) {}
+	
+	StringTable::StringTable(StringTable&&) noexcept = default;
+	
+	StringTable& StringTable::operator=(StringTable&&) noexcept = default;
+	
+	StringTable::~StringTable() = default;
+	
+	InternedString StringTable::intern(std::string_view string) {
+		if (string.empty()) {
+			return {};
+		}
+		if (auto const itr = mState->lookup.find(string); itr != mState->lookup.end()) {
+			return mState->handle(itr->second);
+		}
+		if (mState->lookup.size() >= mState->sweepThreshold) {
+			sweep();
+		}
+		std::uint32_t index;
+		if (!mState->freeSlots.empty()) {
+			index = mState->freeSlots.back();
+			mState->freeSlots.pop_back();
+		}
+		else {
+			index = static_cast<std::uint32_t>(mState->entries.size());
+			mState->entries.push_back(nullptr);
+		}
+		auto* const entry = new State::Entry{ std::string(string), mState->id, index };
+		mState->entries[index] = entry;
+		mState->lookup[std::string_view(entry->string)] = entry;
+		return mState->handle(entry);
+	}
+	
+	InternedString StringTable::find(std::string_view string) const {
+		auto const itr = mState->lookup.find(string);
+		return itr == mState->lookup.end() ? InternedString() : mState->handle(itr->second);
+	}
+	
+	void StringTable::adopt(InternedString& string) {
+		auto const* const entry = string.mEntry;
+		if (!entry || entry->tableID == mState->id) {
+			return;
+		}
+		// Entries keep their index when a table is copied, so the string comparison almost always succeeds.
+		if (entry->index < mState->entries.size()) {
+			if (auto* const candidate = mState->entries[entry->index]; candidate && candidate->string == entry->string) {
+				string = mState->handle(candidate);
+				return;
+			}
+		}
+		string = intern(entry->string);
+	}
+	
+	StringTable StringTable::copy() const {
+		StringTable result;
+		auto& state = *result.mState;
+		state.entries.reserve(mState->entries.size());
+		for (auto const* const entry: mState->entries) {
+			state.entries.push_back(entry ? new State::Entry{ entry->string, state.id, entry->index } : nullptr);
+			if (entry) {
+				state.lookup[std::string_view(state.entries.back()->string)] = state.entries.back();
+			}
+		}
+		state.freeSlots = mState->freeSlots;
+		state.sweepThreshold = mState->sweepThreshold;
+		return result;
+	}
+	
+	std::size_t StringTable::size() const {
+		return mState->lookup.size();
+	}
+	
+	void StringTable::sweep() {
+		for (auto& entry: mState->entries) {
+			// Only the table refers to it, and no other thread can obtain a handle without having one already.
+			if (!entry || entry->references.load(std::memory_order_acquire) != 1) {
+				continue;
+			}
+			mState->lookup.erase(std::string_view(entry->string));
+			mState->freeSlots.push_back(entry->index);
+			entry->release();
+			entry = nullptr;
+		}
+		mState->sweepThreshold = std::max<std::size_t>(64, 2 * mState->lookup.size());
+	}
+	
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <yaml-cpp/yaml.h>
+
+namespace bloom {
+	
+	class StringTable;
+	
+	/// Reference counted handle to an immutable string.
+	/// Handles obtained from a \p StringTable share one allocation per distinct string, so copies do not allocate.
+	/// Handles constructed from a plain string own a private copy until a table adopts them.
+	/// Handles may be copied and destroyed on any thread.
+	class BLOOM_API InternedString {
+	public:
+		InternedString() = default;
+		InternedString(std::string_view);
+		InternedString(std::string const& string): InternedString(std::string_view(string)) {}
+		InternedString(char const* string): InternedString(std::string_view(string)) {}
+		InternedString(InternedString const&);
+		InternedString(InternedString&& rhs) noexcept: mEntry(std::exchange(rhs.mEntry, nullptr)) {}
+		InternedString& operator=(InternedString const&);
+		InternedString& operator=(InternedString&&) noexcept;
+		~InternedString();
+		
+		std::string_view view() const;
+		/// Always null terminated.
+		char const* c_str() const;
+		bool empty() const { return view().empty(); }
+		
+		operator std::string_view() const { return view(); }
+		
+		/// Handles of the same table compare by pointer, everything else by value.
+		friend bool operator==(InternedString const& a, InternedString const& b) {
+			return a.mEntry == b.mEntry || a.view() == b.view();
+		}
+		
+		std::size_t hash() const { return std::hash<std::string_view>{}(view()); }
+	
+	private:
+		friend class StringTable;
+		struct Entry;
+		
+		/// Takes over one reference to \p entry.
+		explicit InternedString(Entry* entry): mEntry(entry) {}
+	
+	private:
+		Entry* mEntry = nullptr;
+	};
+	
+	/// Strings of one scene, lives in its registry context.
+	/// Not thread safe, only the handles it hands out are. Strings no handle refers to anymore
+	/// are released once the table has grown to twice its size after the last sweep.
+	class BLOOM_API StringTable {
+	public:
+		StringTable();
+		StringTable(StringTable&&) noexcept;
+		StringTable& operator=(StringTable&&) noexcept;
+		~StringTable();
+		
+		/// Returns the handle to the string equal to \p string, adding it if the table does not hold it yet.
+		InternedString intern(std::string_view string);
+		
+		/// Returns the handle to the string equal to \p string or an empty handle if the table does not hold it.
+		/// Unlike \p intern(), this never adds to the table.
+		InternedString find(std::string_view string) const;
+		
+		/// Makes \p string refer to the entry of this table. Handles into a table this one was copied from
+		/// are resolved by index, everything else is looked up.
+		void adopt(InternedString& string);
+		
+		/// Copies every entry, keeping their indices.
+		StringTable copy() const;
+		
+		/// Number of strings held, including the ones waiting to be swept.
+		std::size_t size() const;
+		
+		/// Releases every string no handle refers to anymore.
+		void sweep();
+	
+	private:
+		struct State;
+		std::unique_ptr<State> mState;
+	};
+	
+}
+
+template <>
+struct std::hash<bloom::InternedString> {
+	std::size_t operator()(bloom::InternedString const& string) const {
+		return string.hash();
+	}
+};
+
+template <>
+struct YAML::convert<bloom::InternedString> {
+	static Node encode(bloom::InternedString const& string) {
+		return Node(std::string(string.view()));
+	}
+	
+	static bool decode(Node const& node, bloom::InternedString& string) {
+		string = node.as<std::string>();
+		return true;
+	}
+};
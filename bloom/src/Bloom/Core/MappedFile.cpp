@@ -0,0 +1,44 @@
+#include "MappedFile.hpp"
+
+#include <utl/format.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bloom {
+	
+	MappedFile::MappedFile(std::filesystem::path const& path) {
+		int const fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw std::runtime_error(utl::format("Failed to open file {}: {}", path, std::strerror(errno)));
+		}
+		struct stat info;
+		if (::fstat(fd, &info) != 0) {
+			::close(fd);
+			throw std::runtime_error(utl::format("Failed to stat file {}: {}", path, std::strerror(errno)));
+		}
+		mSize = static_cast<std::size_t>(info.st_size);
+		// Empty files can not be mapped.
+		if (mSize > 0) {
+			void* const address = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (address == MAP_FAILED) {
+				::close(fd);
+				throw std::runtime_error(utl::format("Failed to map file {}: {}", path, std::strerror(errno)));
+			}
+			mData = static_cast<std::byte const*>(address);
+		}
+		// The mapping stays valid after closing the descriptor.
+		::close(fd);
+	}
+	
+	MappedFile::~MappedFile() {
+		if (mData) {
+			::munmap(const_cast<std::byte*>(mData), mSize);
+		}
+	}
+	
+}
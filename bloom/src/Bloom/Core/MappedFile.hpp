@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace bloom {
+	
+	/// Read only mapping of a whole file. Pages are read lazily on first access and are backed by the page cache,
+	/// so nothing is copied into the heap.
+	class BLOOM_API MappedFile {
+	public:
+		/// Maps the file at \p path. Throws \p std::runtime_error if it can not be opened or mapped.
+		explicit MappedFile(std::filesystem::path const& path);
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+		~MappedFile();
+		
+		/// The mapping starts at a page boundary.
+		std::span<std::byte const> data() const { return { mData, mSize }; }
+		std::size_t size() const { return mSize; }
+	
+	private:
+		std::byte const* mData = nullptr;
+		std::size_t mSize = 0;
+	};
+	
+}
@@ -0,0 +1,90 @@
+#include "TaskGraph.hpp"
+
+#include "Debug.hpp"
+#include "ThreadPool.hpp"
+
+namespace bloom {
+	
+	TaskGraph::TaskID TaskGraph::add(utl::function<void()> task) {
+		mNodes.push_back({ .task = std::move(task) });
+		return mNodes.size() - 1;
+	}
+	
+	void TaskGraph::precede(TaskID before, TaskID after) {
+		bloomExpect(before < mNodes.size() && after < mNodes.size());
+		bloomExpect(before != after);
+		mNodes[before].successors.push_back(after);
+		++mNodes[after].dependencyCount;
+	}
+	
+	void TaskGraph::clear() {
+		mNodes.clear();
+	}
+	
+	void TaskGraph::run(ThreadPool& threadPool) {
+		if (mNodes.empty()) {
+			return;
+		}
+		bloomExpect(isAcyclic(), "Dependencies of the task graph form a cycle");
+		
+		mRemaining = std::make_unique<std::atomic_size_t[]>(mNodes.size());
+		for (TaskID id = 0; id < mNodes.size(); ++id) {
+			mRemaining[id].store(mNodes[id].dependencyCount, std::memory_order_relaxed);
+		}
+		
+		// Tasks of the graph are submitted to its own group, so waiting never runs unrelated jobs.
+		for (TaskID id = 0; id < mNodes.size(); ++id) {
+			if (mNodes[id].dependencyCount == 0) {
+				threadPool.submit(mGroup, [this, &threadPool, id]{ runFrom(threadPool, id); });
+			}
+		}
+		threadPool.wait(mGroup);
+	}
+	
+	void TaskGraph::runFrom(ThreadPool& threadPool, TaskID id) {
+		// Continue with one of the successors that became ready on this thread, submit the others.
+		while (true) {
+			Node& node = mNodes[id];
+			node.task();
+			TaskID next = mNodes.size();
+			for (TaskID successor: node.successors) {
+				if (mRemaining[successor].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+					continue;
+				}
+				if (next != mNodes.size()) {
+					threadPool.submit(mGroup, [this, &threadPool, next]{ runFrom(threadPool, next); });
+				}
+				next = successor;
+			}
+			// Successors are submitted before this task is counted as complete, so the group never drains early.
+			if (next == mNodes.size()) {
+				return;
+			}
+			id = next;
+		}
+	}
+	
+	bool TaskGraph::isAcyclic() const {
+		utl::vector<std::size_t> remaining;
+		utl::vector<TaskID> ready;
+		for (TaskID id = 0; id < mNodes.size(); ++id) {
+			remaining.push_back(mNodes[id].dependencyCount);
+			if (remaining.back() == 0) {
+				ready.push_back(id);
+			}
+		}
+		std::size_t visited = 0;
+		while (!ready.empty()) {
+			TaskID const id = ready.back();
+			ready.pop_back();
+			++visited;
+			for (TaskID successor: mNodes[id].successors) {
+				if (--remaining[successor] == 0) {
+					ready.push_back(successor);
+				}
+			}
+		}
+		return visited == mNodes.size();
+	}
+	
+}
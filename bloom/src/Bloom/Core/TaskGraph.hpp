@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Base.hpp"
+#include "ThreadPool.hpp"
+
+#include <utl/functional.hpp>
+#include <utl/vector.hpp>
+#include <atomic>
+#include <memory>
+
+namespace bloom {
+	
+	/// Set of tasks with ordering constraints between them, executed on a \p ThreadPool.
+	/// A graph can be run any number of times, but must not be modified while running.
+	class BLOOM_API TaskGraph {
+	public:
+		using TaskID = std::size_t;
+		
+		TaskGraph() = default;
+		TaskGraph(TaskGraph const&) = delete;
+		TaskGraph& operator=(TaskGraph const&) = delete;
+		
+		TaskID add(utl::function<void()> task);
+		
+		/// \p after will only start once \p before has completed.
+		void precede(TaskID before, TaskID after);
+		
+		std::size_t size() const { return mNodes.size(); }
+		
+		void clear();
+		
+		/// Runs every task and returns once all have completed. The calling thread helps processing them.
+		/// Tasks run in parallel unless ordered by \p precede().
+		void run(ThreadPool&);
+	
+	private:
+		struct Node {
+			utl::function<void()> task;
+			utl::vector<TaskID> successors;
+			std::size_t dependencyCount = 0;
+		};
+		
+		void runFrom(ThreadPool&, TaskID);
+		bool isAcyclic() const;
+	
+	private:
+		utl::vector<Node> mNodes;
+		/// Number of unfinished dependencies per task during a run.
+		std::unique_ptr<std::atomic_size_t[]> mRemaining;
+		ThreadPool::TaskGroup mGroup;
+	};
+	
+}
@@ -0,0 +1,187 @@
+#include "ThreadPool.hpp"
+
+#include "Debug.hpp"
+
+#include <algorithm>
+
+namespace bloom {
+	
+	/// Pool and queue index of the worker running on the current thread.
+	static thread_local ThreadPool const* tCurrentPool = nullptr;
+	static thread_local std::size_t tWorkerIndex = 0;
+	
+	ThreadPool::ThreadPool(std::size_t workerCount) {
+		mQueues.reserve(workerCount + 1);
+		for (std::size_t i = 0; i < workerCount + 1; ++i) {
+			mQueues.push_back(std::make_unique<Queue>());
+		}
+		mWorkers.reserve(workerCount);
+		for (std::size_t i = 0; i < workerCount; ++i) {
+			mWorkers.push_back(std::thread(&ThreadPool::workerMain, this, i));
+		}
+	}
+	
+	ThreadPool::~ThreadPool() {
+		{
+			std::unique_lock lock(mMutex);
+			mStop = true;
+		}
+		mWorkCV.notify_all();
+		for (auto& worker: mWorkers) {
+			worker.join();
+		}
+		// Without workers nobody else would run them.
+		while (tryRunTask()) {}
+	}
+	
+	std::size_t ThreadPool::defaultWorkerCount() {
+		std::size_t const hardwareThreads = std::thread::hardware_concurrency();
+		return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+	
+	bool ThreadPool::isWorkerThread() const {
+		return tCurrentPool == this;
+	}
+	
+	void ThreadPool::submit(Task task) {
+		push({ std::move(task) });
+	}
+	
+	void ThreadPool::submit(TaskGroup& group, Task task) {
+		group.pending.fetch_add(1, std::memory_order_relaxed);
+		push({ std::move(task), &group });
+	}
+	
+	void ThreadPool::push(QueuedTask task) {
+		Queue& queue = isWorkerThread() ? *mQueues[tWorkerIndex] : *mQueues.back();
+		// Count before pushing, so the counter never undercounts the queued tasks.
+		mQueuedTasks.fetch_add(1, std::memory_order_relaxed);
+		{
+			std::unique_lock lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+		// Taking the lock orders this with the check of a worker that is about to sleep.
+		{
+			std::unique_lock lock(mMutex);
+		}
+		mWorkCV.notify_one();
+	}
+	
+	bool ThreadPool::tryRunTask() {
+		auto task = takeTask(nullptr);
+		if (!task) {
+			return false;
+		}
+		runTask(*task);
+		return true;
+	}
+	
+	void ThreadPool::wait(std::atomic_size_t const& pending) {
+		while (pending.load(std::memory_order_acquire) != 0) {
+			if (!tryRunTask()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+	
+	void ThreadPool::wait(TaskGroup& group) {
+		while (group.pending.load(std::memory_order_acquire) != 0) {
+			if (auto task = takeTask(&group)) {
+				runTask(*task);
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+	}
+	
+	void ThreadPool::runTask(QueuedTask& task) {
+		task.task();
+		// The group may be destroyed as soon as its last task is counted.
+		if (task.group) {
+			task.group->pending.fetch_sub(1, std::memory_order_release);
+		}
+	}
+	
+	std::optional<ThreadPool::QueuedTask> ThreadPool::takeTask(TaskGroup* group) {
+		if (mQueuedTasks.load(std::memory_order_relaxed) == 0) {
+			return std::nullopt;
+		}
+		auto const matches = [&](QueuedTask const& task) { return !group || task.group == group; };
+		auto take = [&](std::deque<QueuedTask>& tasks, auto itr) {
+			QueuedTask task = std::move(*itr);
+			tasks.erase(itr);
+			mQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+			return std::optional<QueuedTask>(std::move(task));
+		};
+		std::size_t const ownIndex = isWorkerThread() ? tWorkerIndex : mQueues.size() - 1;
+		if (isWorkerThread()) {
+			Queue& own = *mQueues[ownIndex];
+			std::unique_lock lock(own.mutex);
+			auto const itr = std::find_if(own.tasks.rbegin(), own.tasks.rend(), matches);
+			if (itr != own.tasks.rend()) {
+				return take(own.tasks, std::next(itr).base());
+			}
+		}
+		// Steal the oldest matching task of the first queue that has any, starting after our own.
+		for (std::size_t i = 1; i <= mQueues.size(); ++i) {
+			Queue& victim = *mQueues[(ownIndex + i) % mQueues.size()];
+			std::unique_lock lock(victim.mutex);
+			auto const itr = std::find_if(victim.tasks.begin(), victim.tasks.end(), matches);
+			if (itr != victim.tasks.end()) {
+				return take(victim.tasks, itr);
+			}
+		}
+		return std::nullopt;
+	}
+	
+	void ThreadPool::workerMain(std::size_t index) {
+		tCurrentPool = this;
+		tWorkerIndex = index;
+		while (true) {
+			if (tryRunTask()) {
+				continue;
+			}
+			std::unique_lock lock(mMutex);
+			mWorkCV.wait(lock, [&]{ return mStop || mQueuedTasks.load(std::memory_order_relaxed) > 0; });
+			if (mStop && mQueuedTasks.load(std::memory_order_relaxed) == 0) {
+				return;
+			}
+		}
+	}
+	
+	void ThreadPool::parallelFor(std::size_t count, std::size_t grainSize,
+								 utl::function<void(std::size_t, std::size_t)> const& function)
+	{
+		bloomExpect(grainSize > 0);
+		if (count == 0) {
+			return;
+		}
+		std::size_t const chunkCount = (count + grainSize - 1) / grainSize;
+		if (mWorkers.empty() || chunkCount == 1) {
+			function(0, count);
+			return;
+		}
+		
+		std::atomic_size_t nextIndex = 0;
+		auto runChunks = [&]{
+			while (true) {
+				std::size_t const begin = nextIndex.fetch_add(grainSize, std::memory_order_relaxed);
+				if (begin >= count) {
+					return;
+				}
+				function(begin, std::min(begin + grainSize, count));
+			}
+		};
+		
+		// Helpers pull chunks until none are left, so chunks are balanced without a task per chunk.
+		std::size_t const helperCount = std::min(chunkCount - 1, mWorkers.size());
+		TaskGroup group;
+		for (std::size_t i = 0; i < helperCount; ++i) {
+			submit(group, runChunks);
+		}
+		runChunks();
+		wait(group);
+	}
+	
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include <utl/functional.hpp>
+#include <utl/vector.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace bloom {
+	
+	/// Work-stealing pool of worker threads.
+	/// Every worker owns a queue. Tasks submitted from a worker go to its own queue and run last in first out,
+	/// idle workers steal the oldest tasks of the others. Threads waiting for tasks help processing them,
+	/// so a pool with zero workers runs everything serially on the waiting thread.
+	class BLOOM_API ThreadPool {
+	public:
+		using Task = utl::function<void()>;
+		
+		/// Tasks of one fork/join call. A thread waiting for a group only helps with tasks of that group,
+		/// so it never picks up an unrelated job like a scene read in the middle of a frame.
+		struct TaskGroup {
+			std::atomic_size_t pending = 0;
+		};
+		
+		explicit ThreadPool(std::size_t workerCount = defaultWorkerCount());
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator=(ThreadPool const&) = delete;
+		/// Runs all queued tasks before joining the workers.
+		~ThreadPool();
+		
+		/// One worker per hardware thread, minus the calling thread.
+		static std::size_t defaultWorkerCount();
+		
+		std::size_t workerCount() const { return mWorkers.size(); }
+		
+		/// True if the calling thread is one of the workers of this pool.
+		bool isWorkerThread() const;
+		
+		/// Schedules \p task to run on any thread of the pool. Tasks must not throw.
+		void submit(Task task);
+		
+		/// Schedules \p task as part of \p group. The group must outlive the task.
+		void submit(TaskGroup& group, Task task);
+		
+		/// Runs one queued task on the calling thread, if there is any.
+		bool tryRunTask();
+		
+		/// Processes queued tasks of any kind on the calling thread until \p pending drops to zero.
+		void wait(std::atomic_size_t const& pending);
+		
+		/// Processes queued tasks of \p group on the calling thread until all tasks of the group have completed.
+		void wait(TaskGroup& group);
+		
+		/// Invokes \p function(begin, end) for consecutive chunks of at most \p grainSize indices covering [0, \p count).
+		/// Chunks are distributed among the workers and the calling thread. Returns once every chunk has completed.
+		/// May be called concurrently and from within tasks.
+		void parallelFor(std::size_t count, std::size_t grainSize,
+						 utl::function<void(std::size_t, std::size_t)> const& function);
+	
+	private:
+		struct QueuedTask {
+			Task task;
+			TaskGroup* group = nullptr;
+		};
+		
+		struct Queue {
+			std::mutex mutex;
+			std::deque<QueuedTask> tasks;
+		};
+		
+		void push(QueuedTask task);
+		void workerMain(std::size_t index);
+		/// Takes a task of \p group, or any task if \p group is null.
+		std::optional<QueuedTask> takeTask(TaskGroup* group);
+		void runTask(QueuedTask& task);
+	
+	private:
+		utl::vector<std::thread> mWorkers;
+		
+		/// One queue per worker, followed by one for tasks submitted from other threads.
+		utl::vector<std::unique_ptr<Queue>> mQueues;
+		
+		/// Upper bound of the number of queued tasks. Idle workers sleep while it is zero.
+		std::atomic_size_t mQueuedTasks = 0;
+		
+		std::mutex mMutex;
+		std::condition_variable mWorkCV;
+		bool mStop = false;
+	};
+	
+}
@@ -8,6 +8,8 @@ namespace bloom {
 	
 	void Timer::reset() {
 		watch.reset();
+		ts = {};
+		preciseTS = {};
 	}
 	
 	void Timer::pause() {
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace bloom {
+	
+	/// Lock-free handoff of values from one producer thread to one consumer thread.
+	/// The producer fills \p back() and publishes it, the consumer reads the latest published value.
+	/// Neither side ever waits for the other; values published in between reads are skipped.
+	template <typename T>
+	class TripleBuffer {
+	public:
+		TripleBuffer() = default;
+		TripleBuffer(TripleBuffer const&) = delete;
+		TripleBuffer& operator=(TripleBuffer const&) = delete;
+		
+		/// MARK: Producer
+		/// Slot owned by the producer. Contains whatever was published two or more rounds ago.
+		T& back() { return mSlots[mBack]; }
+		
+		/// Makes the contents of \p back() available to the consumer and hands the producer another slot.
+		void publish() {
+			std::uint8_t const previous = mMiddle.exchange(mBack | freshBit, std::memory_order_acq_rel);
+			mBack = previous & indexMask;
+		}
+		
+		/// MARK: Consumer
+		/// Latest published value. Stays valid and unchanged until the next call to \p consume().
+		T const& consume() {
+			if (mMiddle.load(std::memory_order_relaxed) & freshBit) {
+				std::uint8_t const previous = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+				mFront = previous & indexMask;
+			}
+			return mSlots[mFront];
+		}
+		
+		/// True if a value was published since the last call to \p consume().
+		bool hasNewValue() const {
+			return mMiddle.load(std::memory_order_relaxed) & freshBit;
+		}
+	
+	private:
+		static constexpr std::uint8_t indexMask = 0b011;
+		static constexpr std::uint8_t freshBit = 0b100;
+		
+		std::array<T, 3> mSlots{};
+		std::uint8_t mBack = 0;
+		std::uint8_t mFront = 1;
+		/// Index of the slot in between, plus \p freshBit if it has not been consumed yet.
+		std::atomic<std::uint8_t> mMiddle = 2;
+	};
+	
+}
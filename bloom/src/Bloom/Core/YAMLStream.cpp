@@ -0,0 +1,137 @@
+#include "YAMLStream.hpp"
+
+#include <utl/hashmap.hpp>
+#include <utl/vector.hpp>
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/parser.h>
+#include <istream>
+#include <optional>
+
+namespace bloom {
+	
+	namespace {
+		/// Builds nodes from parser events like \p YAML::Load() does, but hands every element of the root sequence on when it is complete.
+		class SequenceElementBuilder: public YAML::EventHandler {
+		public:
+			explicit SequenceElementBuilder(utl::function<void(YAML::Node const&)> const& function):
+				mFunction(function) {}
+			
+			bool foundSequence() const { return mFoundSequence; }
+			
+			void OnDocumentStart(YAML::Mark const&) override {}
+			void OnDocumentEnd() override {}
+			
+			void OnNull(YAML::Mark const&, YAML::anchor_t anchor) override {
+				if (!mStarted) {
+					// Empty document.
+					mStarted = true;
+					return;
+				}
+				add(YAML::Node(YAML::NodeType::Null), anchor);
+			}
+			
+			void OnAlias(YAML::Mark const& mark, YAML::anchor_t anchor) override {
+				auto const itr = mAnchors.find(anchor);
+				if (itr == mAnchors.end()) {
+					throw YAML::ParserException(mark, "Unknown anchor");
+				}
+				add(itr->second, 0);
+			}
+			
+			void OnScalar(YAML::Mark const& mark, std::string const& tag, YAML::anchor_t anchor, std::string const& value) override {
+				expectStarted(mark);
+				YAML::Node node(value);
+				node.SetTag(tag);
+				add(node, anchor);
+			}
+			
+			void OnSequenceStart(YAML::Mark const&, std::string const& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override {
+				if (!mStarted) {
+					mStarted = true;
+					mFoundSequence = true;
+					return;
+				}
+				push(YAML::Node(YAML::NodeType::Sequence), tag, anchor, style);
+			}
+			
+			void OnSequenceEnd() override {
+				if (!mStack.empty()) {
+					pop();
+				}
+			}
+			
+			void OnMapStart(YAML::Mark const& mark, std::string const& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override {
+				expectStarted(mark);
+				push(YAML::Node(YAML::NodeType::Map), tag, anchor, style);
+			}
+			
+			void OnMapEnd() override {
+				pop();
+			}
+		
+		private:
+			struct Frame {
+				YAML::Node node;
+				/// Key of a map that is waiting for its value.
+				std::optional<YAML::Node> key;
+			};
+			
+			void expectStarted(YAML::Mark const& mark) {
+				if (!mStarted) {
+					throw YAML::ParserException(mark, "Expected a sequence");
+				}
+			}
+			
+			void push(YAML::Node node, std::string const& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) {
+				node.SetTag(tag);
+				node.SetStyle(style);
+				if (anchor) {
+					mAnchors[anchor] = node;
+				}
+				mStack.push_back({ std::move(node), std::nullopt });
+			}
+			
+			void pop() {
+				auto node = std::move(mStack.back().node);
+				mStack.pop_back();
+				add(node, 0);
+			}
+			
+			void add(YAML::Node const& node, YAML::anchor_t anchor) {
+				if (anchor) {
+					mAnchors[anchor] = node;
+				}
+				if (mStack.empty()) {
+					mFunction(node);
+					return;
+				}
+				auto& frame = mStack.back();
+				if (frame.node.IsSequence()) {
+					frame.node.push_back(node);
+				}
+				else if (!frame.key) {
+					frame.key = node;
+				}
+				else {
+					// Keys are not looked up again, which keeps large maps linear.
+					frame.node.force_insert(*frame.key, node);
+					frame.key.reset();
+				}
+			}
+			
+			utl::function<void(YAML::Node const&)> const& mFunction;
+			utl::vector<Frame> mStack;
+			utl::hashmap<YAML::anchor_t, YAML::Node> mAnchors;
+			bool mStarted = false;
+			bool mFoundSequence = false;
+		};
+	}
+	
+	bool forEachSequenceElement(std::istream& stream, utl::function<void(YAML::Node const&)> const& function) {
+		YAML::Parser parser(stream);
+		SequenceElementBuilder builder(function);
+		parser.HandleNextDocument(builder);
+		return builder.foundSequence();
+	}
+	
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Bloom/Core/Base.hpp"
+
+#include <utl/functional.hpp>
+#include <yaml-cpp/yaml.h>
+#include <iosfwd>
+
+namespace bloom {
+	
+	/// Parses the first document of \p stream and invokes \p function with every element of its root sequence as soon as the element is complete.
+	/// Only the element being read is held in memory, unlike \p YAML::Load() which builds the whole document first.
+	/// @returns	False if the document is empty. Throws \p YAML::Exception on syntax errors and if the root is not a sequence.
+	BLOOM_API bool forEachSequenceElement(std::istream& stream, utl::function<void(YAML::Node const&)> const& function);
+	
+}
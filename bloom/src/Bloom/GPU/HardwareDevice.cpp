@@ -1,13 +1,17 @@
 #include "HardwareDevice.hpp"
 
+#ifndef BLOOM_HEADLESS
 #include "Bloom/Platform/Metal/MetalDevice.h"
+#endif
 
 namespace bloom {
 	
 	std::unique_ptr<HardwareDevice> HardwareDevice::create(RenderAPI api) {
 		switch (api) {
+#ifndef BLOOM_HEADLESS
 			case RenderAPI::metal:
 				return createMetalDevice();
+#endif
 				
 			default:
 				return nullptr;
@@ -24,7 +24,7 @@ namespace bloom {
 		mParameters = root["Parameters"].as<MaterialParameters>();
 		auto const matHandle = root["Material"].as<AssetHandle>();
 		mMaterial = as<Material>(assetManager.get(matHandle));
-		assetManager.makeAvailable(matHandle, AssetRepresentation::GPU);
+		assetManager.makeAvailableAsync(matHandle, AssetRepresentation::GPU);
 	}
 	
 }
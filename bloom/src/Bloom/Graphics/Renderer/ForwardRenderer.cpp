@@ -4,6 +4,7 @@
 #include "Bloom/Graphics/Material/Material.hpp"
 #include "Bloom/Graphics/Material/MaterialInstance.hpp"
 #include "Bloom/Graphics/StaticMesh.hpp"
+#include "Bloom/Scene/TransformKernels.hpp"
 
 #include <numeric>
 #include <utl/utility.hpp>
@@ -168,6 +169,10 @@ namespace bloom {
 				desc.storageMode = StorageMode::managed;
 				renderObjects.transformBuffer = device().createBuffer(desc);
 			}
+			// Transforms are submitted in row major order, the shaders expect column major matrices.
+			transposeMatrices(scene.objects.data().transform,
+							  scene.objects.data().transform,
+							  scene.objects.size());
 			device().fillManagedBuffer(renderObjects.transformBuffer,
 									   scene.objects.data().transform,
 									   size);
@@ -194,6 +199,10 @@ namespace bloom {
 		RendererSanitizer::submit();
 		bloomAssert((bool)matInst);
 		bloomAssert(matInst->material());
+		if (!mesh || !matInst->material()->mainPass) {
+			// Still loading.
+			return;
+		}
 		
 		if (matInst->mDirty) {
 			matInst->mDirty = false;
@@ -202,7 +211,7 @@ namespace bloom {
 			}
 			device().fillManagedBuffer(matInst->mParameterBuffer, &matInst->mParameters, sizeof(MaterialParameters));
 		}
-		scene.objects.push_back({ mtl::transpose(transform), std::move(matInst), std::move(mesh) });
+		scene.objects.push_back({ transform, std::move(matInst), std::move(mesh) });
 	}
 	
 	void ForwardRenderer::submit(PointLight const& light) {
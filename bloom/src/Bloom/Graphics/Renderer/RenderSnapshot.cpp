@@ -0,0 +1,67 @@
+#include "RenderSnapshot.hpp"
+
+#include "Bloom/Scene/Scene.hpp"
+#include "Bloom/Scene/Components/Lights.hpp"
+#include "Bloom/Scene/Components/Transform.hpp"
+#include "Bloom/Scene/Components/MeshRenderer.hpp"
+
+namespace bloom {
+	
+	void RenderSnapshot::clear() {
+		meshes.clear();
+		pointLights.clear();
+		spotLights.clear();
+		directionalLights.clear();
+		skyLights.clear();
+	}
+	
+	template <typename LightComponent, typename Light>
+	static void extractLights(Scene const& scene, utl::vector<Light>& lights) {
+		auto view = scene.view<TransformMatrixComponent const, LightComponent const>();
+		view.each([&](auto id, TransformMatrixComponent const& transform, LightComponent const& light) {
+			lights.push_back(toWorld(light.light, transform.matrix));
+		});
+	}
+	
+	void RenderSnapshot::extract(Scene const& scene) {
+		auto view = scene.view<TransformMatrixComponent const, MeshRendererComponent const>();
+		view.each([&](auto const id, TransformMatrixComponent const& transform, MeshRendererComponent const& meshRenderer) {
+			if (!meshRenderer.mesh || !meshRenderer.materialInstance || !meshRenderer.materialInstance->material()) {
+				return;
+			}
+			meshes.push_back({
+				.scene = &scene,
+				.entity = id,
+				.mesh = meshRenderer.mesh->getRenderer(),
+				.materialInstance = meshRenderer.materialInstance,
+				.transform = transform.matrix
+			});
+		});
+		extractLights<PointLightComponent>(scene, pointLights);
+		extractLights<SpotLightComponent>(scene, spotLights);
+		extractLights<DirectionalLightComponent>(scene, directionalLights);
+		extractLights<SkyLightComponent>(scene, skyLights);
+	}
+	
+	/// MARK: World space lights
+	PointLight toWorld(PointLight light, mtl::float4x4 const& transform) {
+		light.position = transform.column(3).xyz;
+		return light;
+	}
+	
+	SpotLight toWorld(SpotLight light, mtl::float4x4 const& transform) {
+		light.position = transform.column(3).xyz;
+		light.direction = mtl::normalize((transform * mtl::float4{ 1, 0, 0, 0 }).xyz);
+		return light;
+	}
+	
+	DirectionalLight toWorld(DirectionalLight light, mtl::float4x4 const& transform) {
+		light.direction = mtl::normalize((transform * mtl::float4{ 0, 0, 1, 0 }).xyz);
+		return light;
+	}
+	
+	SkyLight toWorld(SkyLight light, mtl::float4x4 const&) {
+		return light;
+	}
+	
+}
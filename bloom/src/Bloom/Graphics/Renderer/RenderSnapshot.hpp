@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Bloom/Core/Base.hpp"
+#include "Bloom/Core/Reference.hpp"
+#include "Bloom/Graphics/Lights.hpp"
+#include "Bloom/Scene/Entity.hpp"
+
+#include <mtl/mtl.hpp>
+#include <utl/vector.hpp>
+
+namespace bloom {
+	
+	class Scene;
+	class StaticMeshRenderer;
+	class MaterialInstance;
+	
+	struct BLOOM_API MeshDraw {
+		/// Identifies the source entity, e.g. to highlight selected entities. Must not be dereferenced by the renderer.
+		Scene const* scene = nullptr;
+		EntityID entity;
+		Reference<StaticMeshRenderer> mesh;
+		Reference<MaterialInstance> materialInstance;
+		mtl::float4x4 transform;
+	};
+	
+	/// Everything the renderer reads from a set of scenes, copied out so rendering can proceed
+	/// on another thread while the simulation keeps modifying the scenes.
+	struct BLOOM_API RenderSnapshot {
+		utl::vector<MeshDraw> meshes;
+		utl::vector<PointLight> pointLights;
+		utl::vector<SpotLight> spotLights;
+		utl::vector<DirectionalLight> directionalLights;
+		utl::vector<SkyLight> skyLights;
+		
+		/// Number of the simulation step after which the snapshot was taken.
+		std::size_t step = 0;
+		
+		/// Keeps the allocations, so refilling a recycled snapshot does not allocate.
+		void clear();
+		
+		/// Appends the renderable state of \p scene. World transforms must be up to date.
+		void extract(Scene const& scene);
+	};
+	
+	/// MARK: World space lights
+	/// Light parameters with position and direction taken from the world \p transform of their entity.
+	BLOOM_API PointLight toWorld(PointLight, mtl::float4x4 const& transform);
+	BLOOM_API SpotLight toWorld(SpotLight, mtl::float4x4 const& transform);
+	BLOOM_API DirectionalLight toWorld(DirectionalLight, mtl::float4x4 const& transform);
+	BLOOM_API SkyLight toWorld(SkyLight, mtl::float4x4 const& transform);
+	
+}
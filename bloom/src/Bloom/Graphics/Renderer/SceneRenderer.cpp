@@ -1,9 +1,11 @@
 #include "SceneRenderer.hpp"
 
 #include "Renderer.hpp"
+#include "RenderSnapshot.hpp"
 
 
 #include "Bloom/Core/Core.hpp"
+#include "Bloom/Graphics/Camera.hpp"
 #include "Bloom/Scene/Scene.hpp"
 #include "Bloom/Scene/Components/Lights.hpp"
 #include "Bloom/Scene/Components/Transform.hpp"
@@ -37,6 +39,7 @@ namespace bloom {
 							 CommandQueue& commandQueue)
 	{
 		bloomExpect(mRenderer);
+		mFrustum = Frustum(camera.viewProjection());
 		renderer().beginScene(camera);
 		
 		for (auto& scene: utl::transform_range(scenes, utl::deref)) {
@@ -50,44 +53,78 @@ namespace bloom {
 		renderer().draw(framebuffer, commandQueue);
 	}
 	
+	void SceneRenderer::draw(RenderSnapshot const& snapshot,
+							 Camera const& camera,
+							 Framebuffer& framebuffer,
+							 CommandQueue& commandQueue)
+	{
+		bloomExpect(mRenderer);
+		renderer().beginScene(camera);
+		
+		mSnapshot = &snapshot;
+		submitSnapshot(snapshot);
+		submitExtra();
+		mSnapshot = nullptr;
+		
+		renderer().endScene();
+		
+		renderer().draw(framebuffer, commandQueue);
+	}
+	
 	template <typename LightComponent>
-	static void submitLights(Renderer& renderer, Scene const& scene, auto&& lightModifier) {
+	static void submitLights(Renderer& renderer, Scene const& scene) {
 		auto view = scene.view<TransformMatrixComponent const, LightComponent const>();
-		view.each([&](auto id, TransformMatrixComponent const& transform, LightComponent light) {
-			lightModifier(transform, light);
-			renderer.submit(light.light);
+		view.each([&](auto id, TransformMatrixComponent const& transform, LightComponent const& light) {
+			renderer.submit(toWorld(light.light, transform.matrix));
 		});
 	}
-
-	template <typename Light>
-	static void submitLights(Renderer& renderer, Scene const& scene) {
-		submitLights<Light>(renderer, scene, utl::noop);
-	}
 	
 	void SceneRenderer::submitScene(Scene const& scene) {
 		/* submit meshes */ {
-			auto view = scene.view<TransformMatrixComponent const, MeshRendererComponent const>();
-			view.each([&](auto const id, TransformMatrixComponent const& transform, MeshRendererComponent const& meshRenderer) {
+			auto submitMesh = [&](TransformMatrixComponent const& transform, MeshRendererComponent const& meshRenderer) {
 				if (!meshRenderer.mesh || !meshRenderer.materialInstance || !meshRenderer.materialInstance->material()) {
 					return;
 				}
 				renderer().submit(meshRenderer.mesh->getRenderer(),
 								  meshRenderer.materialInstance,
 								  transform.matrix);
-			});
+			};
+			if (mFrustumCulling) {
+				scene.spatialIndex().query(mFrustum, [&](EntityID id) {
+					submitMesh(scene.getComponent<TransformMatrixComponent>(id),
+							   scene.getComponent<MeshRendererComponent>(id));
+				});
+			}
+			else {
+				auto view = scene.view<TransformMatrixComponent const, MeshRendererComponent const>();
+				view.each([&](auto const id, TransformMatrixComponent const& transform, MeshRendererComponent const& meshRenderer) {
+					submitMesh(transform, meshRenderer);
+				});
+			}
 		}
 		
-		submitLights<PointLightComponent>(renderer(), scene, [](auto& transform, auto& light) {
-			light.light.position = transform.matrix.column(3).xyz;
-		});
-		submitLights<SpotLightComponent>(renderer(), scene, [](auto& transform, auto& light) {
-			light.light.position = transform.matrix.column(3).xyz;
-			light.light.direction = mtl::normalize((transform.matrix * mtl::float4{ 1, 0, 0, 0 }).xyz);
-		});
-		submitLights<DirectionalLightComponent>(renderer(), scene, [](auto& transform, auto& light) {
-			light.light.direction = mtl::normalize((transform.matrix * mtl::float4{ 0, 0, 1, 0 }).xyz);
-		});
+		submitLights<PointLightComponent>(renderer(), scene);
+		submitLights<SpotLightComponent>(renderer(), scene);
+		submitLights<DirectionalLightComponent>(renderer(), scene);
 		submitLights<SkyLightComponent>(renderer(), scene);
 	}
 	
+	void SceneRenderer::submitSnapshot(RenderSnapshot const& snapshot) {
+		for (auto const& mesh: snapshot.meshes) {
+			renderer().submit(mesh.mesh, mesh.materialInstance, mesh.transform);
+		}
+		for (auto const& light: snapshot.pointLights) {
+			renderer().submit(light);
+		}
+		for (auto const& light: snapshot.spotLights) {
+			renderer().submit(light);
+		}
+		for (auto const& light: snapshot.directionalLights) {
+			renderer().submit(light);
+		}
+		for (auto const& light: snapshot.skyLights) {
+			renderer().submit(light);
+		}
+	}
+	
 }
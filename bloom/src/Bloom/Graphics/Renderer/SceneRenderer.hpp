@@ -1,4 +1,5 @@
 #include "Bloom/Core/Core.hpp"
+#include "Bloom/Core/Geometry.hpp"
 
 #include <span>
 
@@ -9,6 +10,7 @@ namespace bloom {
 	class CommandQueue;
 	class Scene;
 	class Camera;
+	struct RenderSnapshot;
 	
 	class BLOOM_API SceneRenderer {
 	public:
@@ -21,13 +23,28 @@ namespace bloom {
 		void draw(Scene const&, Camera const&, Framebuffer&, CommandQueue&);
 		void draw(std::span<Scene const* const>, Camera const&, Framebuffer&, CommandQueue&);
 		
+		/// Draws state extracted from the scenes earlier, possibly on another thread. Does not touch any scene.
+		void draw(RenderSnapshot const&, Camera const&, Framebuffer&, CommandQueue&);
+		
+		/// Only submit meshes whose bounds intersect the view frustum, looked up in the spatial index of the scene.
+		/// Off by default, since meshes outside of the view may still cast shadows into it.
+		void setFrustumCulling(bool value) { mFrustumCulling = value; }
+		bool frustumCulling() const { return mFrustumCulling; }
+		
 	protected:
 		/// Overridable
 		virtual void submitScene(Scene const&);
+		virtual void submitSnapshot(RenderSnapshot const&);
 		virtual void submitExtra() {}
 		
+		/// The snapshot being drawn while drawing from a snapshot, null otherwise.
+		RenderSnapshot const* currentSnapshot() const { return mSnapshot; }
+		
 	private:
 		Renderer* mRenderer = nullptr;
+		RenderSnapshot const* mSnapshot = nullptr;
+		Frustum mFrustum;
+		bool mFrustumCulling = false;
 	};
 	
 }
@@ -1,5 +1,53 @@
 #include "StaticMesh.hpp"
 
-namespace bloom {
+#include "Bloom/Core/MappedFile.hpp"
+
+#include <limits>
 
+namespace bloom {
+	
+	StaticMeshData::StaticMeshData(utl::vector<Vertex3D> vertices, utl::vector<std::uint32_t> indices):
+		mVertexStorage(std::move(vertices)),
+		mIndexStorage(std::move(indices)),
+		mVertices(mVertexStorage.data(), mVertexStorage.size()),
+		mIndices(mIndexStorage.data(), mIndexStorage.size())
+	{}
+	
+	StaticMeshData::StaticMeshData(Reference<MappedFile const> file,
+								   std::span<Vertex3D const> vertices,
+								   std::span<std::uint32_t const> indices):
+		mFile(std::move(file)),
+		mVertices(vertices),
+		mIndices(indices)
+	{}
+	
+	StaticMeshData::StaticMeshData(StaticMeshData&& rhs) noexcept {
+		*this = std::move(rhs);
+	}
+	
+	StaticMeshData& StaticMeshData::operator=(StaticMeshData&& rhs) noexcept {
+		mVertexStorage = std::move(rhs.mVertexStorage);
+		mIndexStorage = std::move(rhs.mIndexStorage);
+		mFile = std::move(rhs.mFile);
+		// Views into owned arrays are pointed at the arrays of this object.
+		mVertices = mFile ? rhs.mVertices : std::span<Vertex3D const>(mVertexStorage.data(), mVertexStorage.size());
+		mIndices = mFile ? rhs.mIndices : std::span<std::uint32_t const>(mIndexStorage.data(), mIndexStorage.size());
+		rhs.mVertices = {};
+		rhs.mIndices = {};
+		return *this;
+	}
+	
+	AABB StaticMeshData::calculateBounds() const {
+		if (mVertices.empty()) {
+			return {};
+		}
+		AABB result = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+		for (auto const& vertex: mVertices) {
+			mtl::float3 const position = { vertex.position[0], vertex.position[1], vertex.position[2] };
+			result.lower = mtl::min(result.lower, position);
+			result.upper = mtl::max(result.upper, position);
+		}
+		return result;
+	}
+	
 }
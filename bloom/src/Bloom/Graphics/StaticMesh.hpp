@@ -3,15 +3,19 @@
 #include "Vertex.hpp"
 
 #include "Bloom/Core/Core.hpp"
+#include "Bloom/Core/Geometry.hpp"
 #include "Bloom/GPU/HardwarePrimitives.hpp"
 #include "Bloom/Asset/Asset.hpp"
 
+#include <optional>
+#include <span>
 #include <utl/vector.hpp>
 
 namespace bloom {
 	
 	class StaticMeshData;
 	class StaticMeshRenderer;
+	class MappedFile;
 	
 	class BLOOM_API StaticMesh: public Asset {
 		friend class AssetManager;
@@ -22,14 +26,41 @@ namespace bloom {
 		Reference<StaticMeshData> getData() { return mData; }
 		Reference<StaticMeshRenderer> getRenderer() { return mRenderer; }
 		
+		/// Model space bounds of the vertices. Known once the mesh has been loaded into either representation.
+		std::optional<AABB> bounds() const { return mBounds; }
+		
 	private:
 		Reference<StaticMeshData> mData;
 		Reference<StaticMeshRenderer> mRenderer;
+		std::optional<AABB> mBounds;
 	};
 	
-	struct BLOOM_API StaticMeshData {
-		utl::vector<Vertex3D> vertices;
-		utl::vector<std::uint32_t> indices;
+	/// Vertices and indices of a static mesh. Either owns its arrays or views into a memory mapped mesh file,
+	/// which it keeps alive.
+	class BLOOM_API StaticMeshData {
+	public:
+		StaticMeshData() = default;
+		StaticMeshData(utl::vector<Vertex3D> vertices, utl::vector<std::uint32_t> indices);
+		/// \p vertices and \p indices must point into \p file.
+		StaticMeshData(Reference<MappedFile const> file,
+					   std::span<Vertex3D const> vertices,
+					   std::span<std::uint32_t const> indices);
+		StaticMeshData(StaticMeshData&&) noexcept;
+		StaticMeshData& operator=(StaticMeshData&&) noexcept;
+		
+		std::span<Vertex3D const> vertices() const { return mVertices; }
+		std::span<std::uint32_t const> indices() const { return mIndices; }
+		
+		bool isMapped() const { return mFile != nullptr; }
+		
+		AABB calculateBounds() const;
+		
+	private:
+		utl::vector<Vertex3D> mVertexStorage;
+		utl::vector<std::uint32_t> mIndexStorage;
+		Reference<MappedFile const> mFile;
+		std::span<Vertex3D const> mVertices;
+		std::span<std::uint32_t const> mIndices;
 	};
 	
 	class BLOOM_API StaticMeshRenderer {
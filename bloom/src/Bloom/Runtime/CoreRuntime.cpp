@@ -1,5 +1,6 @@
 #include "CoreRuntime.hpp"
 
+#include "Replay.hpp"
 #include "Scene.hpp"
 #include "ScriptSystem.hpp"
 
@@ -11,9 +12,12 @@
 #include "Bloom/Scene/Components/AllComponents.hpp"
 
 #include <utl/scope_guard.hpp>
+#include <algorithm>
 
 namespace bloom {
     
+	CoreRuntime::CoreRuntime() = default;
+	
 	CoreRuntime::CoreRuntime(std::shared_ptr<RuntimeDelegate> delegate):
 		mDelegate(std::move(delegate))
 	{
@@ -24,60 +28,121 @@ namespace bloom {
 		stop();
 	}
 	
+	/// MARK: Queries
+	UpdateOptions CoreRuntime::updateOptions() const {
+		return {
+			.stepsPerSecond = mStepsPerSecond.load(std::memory_order_relaxed),
+			.maxCatchUpSteps = mMaxCatchUpSteps.load(std::memory_order_relaxed)
+		};
+	}
+	
+	double CoreRuntime::interpolationAlpha() const {
+		auto const state = mState.load(std::memory_order_acquire);
+		auto const stepDuration = mStepDuration.load(std::memory_order_relaxed);
+		if (state == RuntimeState::inactive || stepDuration == 0) {
+			return 0;
+		}
+		// The values are read independently and may belong to different steps, which the clamp absorbs.
+		auto const now = state == RuntimeState::paused ?
+			mPauseTime.load(std::memory_order_relaxed) : Clock::now().time_since_epoch().count();
+		double const alpha = double(now - mStepReference.load(std::memory_order_relaxed)) / stepDuration;
+		return std::clamp(alpha, 0.0, 1.0);
+	}
+	
 	/// MARK: Modifiers
 	void CoreRuntime::setDelegate(std::shared_ptr<RuntimeDelegate> delegate) {
-		std::unique_lock lock(mMutex);
-		if (mState != RuntimeState::inactive) {
+		std::unique_lock lock(mControlMutex);
+		if (state() != RuntimeState::inactive) {
 			return;
 		}
 		mDelegate = std::move(delegate);
 	}
 	
+	void CoreRuntime::setUpdateOptions(UpdateOptions options) {
+		mStepsPerSecond.store(options.stepsPerSecond, std::memory_order_relaxed);
+		mMaxCatchUpSteps.store(options.maxCatchUpSteps, std::memory_order_relaxed);
+	}
+	
 	void CoreRuntime::run() {
-		std::unique_lock lock(mMutex);
-		if (state() == RuntimeState::running) {
+		std::unique_lock lock(mControlMutex);
+		if (state() != RuntimeState::inactive) {
 			return;
 		}
-		if (state() == RuntimeState::paused) {
-			return;
+		{
+			std::unique_lock inputLock(mInputMutex);
+			mPendingInput.clear();
+			mHasPendingInput = false;
 		}
-		
-		bloomAssert(state() == RuntimeState::inactive);
-		
 		setState(RuntimeState::running);
-		lock.unlock();
 		mUpdateThread = std::thread([this]{
 			updateThread();
 		});
 	}
 	
 	void CoreRuntime::stop() {
-		std::unique_lock lock(mMutex);
+		std::unique_lock lock(mControlMutex);
 		setState(RuntimeState::inactive);
-		lock.unlock();
 		if (mUpdateThread.joinable()) {
 			mUpdateThread.join();
 		}
+		if (!mRecording) {
+			mRecorder.reset();
+		}
 	}
 	
 	void CoreRuntime::pause() {
-		std::unique_lock lock(mMutex);
-		if (mState != RuntimeState::running) {
+		std::unique_lock lock(mControlMutex);
+		if (state() != RuntimeState::running) {
 			return;
 		}
-		mTimer.pause();
+		mPauseTime.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
 		setState(RuntimeState::paused);
 	}
 	
 	void CoreRuntime::resume() {
-		std::unique_lock lock(mMutex);
-		if (mState != RuntimeState::paused) {
+		std::unique_lock lock(mControlMutex);
+		if (state() != RuntimeState::paused) {
 			return;
 		}
-		mTimer.resume();
+		auto const pauseDuration = Clock::now().time_since_epoch().count() - mPauseTime.load(std::memory_order_relaxed);
+		mStepReference.fetch_add(pauseDuration, std::memory_order_relaxed);
 		setState(RuntimeState::running);
 	}
 	
+	void CoreRuntime::submitInput(InputEvent const& event) {
+		if (state() == RuntimeState::inactive) {
+			return;
+		}
+		std::unique_lock lock(mInputMutex);
+		mPendingInput.push_back(event);
+		mHasPendingInput.store(true, std::memory_order_release);
+	}
+	
+	/// MARK: Recording
+	void CoreRuntime::startRecording(std::ostream& stream) {
+		std::unique_lock lock(mControlMutex);
+		if (state() != RuntimeState::inactive) {
+			bloomLog(error, "Failed to start recording. Recording must start before the runtime.");
+			return;
+		}
+		mRecorder = std::make_unique<ReplayWriter>(stream, ReplayHeader{
+			.stepsPerSecond = static_cast<std::uint32_t>(mStepsPerSecond.load(std::memory_order_relaxed))
+		});
+		mRecording = true;
+	}
+	
+	void CoreRuntime::stopRecording() {
+		std::unique_lock lock(mControlMutex);
+		mRecording = false;
+		if (state() == RuntimeState::inactive) {
+			mRecorder.reset();
+		}
+	}
+	
+	bool CoreRuntime::isRecording() const {
+		return mRecording;
+	}
+	
 	/// MARK: Private
 	void CoreRuntime::updateThread() {
 		mTimer.reset();
@@ -92,24 +157,57 @@ namespace bloom {
 			}
 		};
 		
+		using Duration = PreciseTimestep::Duration;
+		Duration accumulator{};
+		double simulationTime = 0;
+		mStepReference.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
 		while (true) {
-			std::unique_lock lock(mMutex);
-			switch (mState) {
-				case RuntimeState::running:
+			switch (mState.load(std::memory_order_acquire)) {
+				case RuntimeState::running: {
 					mTimer.update();
-					lock.unlock();
-					if (mDelegate) {
-						mDelegate->step(Timestep{});
+					auto const now = Clock::now();
+					std::size_t const stepsPerSecond = mStepsPerSecond.load(std::memory_order_relaxed);
+					
+					if (stepsPerSecond == 0) {
+						mStepDuration.store(0, std::memory_order_relaxed);
+						runStep(mTimer.timestep());
+						std::this_thread::yield();
+						break;
+					}
+					
+					auto const stepDuration = std::chrono::duration_cast<Duration>(std::chrono::seconds(1)) /
+						static_cast<Duration::rep>(stepsPerSecond);
+					auto const maxSteps = static_cast<Duration::rep>(std::max<std::size_t>(mMaxCatchUpSteps.load(std::memory_order_relaxed), 1));
+					mStepDuration.store(std::chrono::duration_cast<Clock::duration>(stepDuration).count(), std::memory_order_relaxed);
+					accumulator = std::min(accumulator + mTimer.preciseTimestep().delta, stepDuration * maxSteps);
+					auto const publishReference = [&]{
+						auto const reference = now - std::chrono::duration_cast<Clock::duration>(accumulator);
+						mStepReference.store(reference.time_since_epoch().count(), std::memory_order_relaxed);
+					};
+					publishReference();
+					
+					if (accumulator < stepDuration) {
+						sleep(std::chrono::duration_cast<Clock::duration>(stepDuration - accumulator));
+						break;
+					}
+					
+					double const delta = std::chrono::duration<double>(stepDuration).count();
+					while (accumulator >= stepDuration) {
+						simulationTime += delta;
+						accumulator -= stepDuration;
+						runStep(Timestep{ .absolute = simulationTime, .delta = delta });
 					}
+					publishReference();
 					break;
+				}
 				case RuntimeState::paused:
+					mTimer.pause();
 					if (mDelegate) {
 						mDelegate->pause();
 					}
-					mCV.wait(lock, [&]{
-						return mState != RuntimeState::paused;
-					});
-					if (mState == RuntimeState::running && mDelegate) {
+					mState.wait(RuntimeState::paused, std::memory_order_acquire);
+					mTimer.resume();
+					if (mState.load(std::memory_order_acquire) == RuntimeState::running && mDelegate) {
 						mDelegate->resume();
 					}
 					break;
@@ -118,13 +216,43 @@ namespace bloom {
 					return;
 			}
 		}
-		
-		
+	}
+	
+	void CoreRuntime::runStep(Timestep timestep) {
+		mStepInput.clear();
+		if (mHasPendingInput.load(std::memory_order_acquire)) {
+			std::unique_lock lock(mInputMutex);
+			std::swap(mStepInput, mPendingInput);
+			mHasPendingInput.store(false, std::memory_order_relaxed);
+		}
+		if (mRecorder) {
+			if (mRecording.load(std::memory_order_relaxed)) {
+				mRecorder->writeStep(timestep, mStepInput);
+			}
+			else {
+				mRecorder.reset();
+			}
+		}
+		if (mDelegate) {
+			mDelegate->input(mStepInput);
+			mDelegate->step(timestep);
+		}
+	}
+	
+	void CoreRuntime::sleep(Clock::duration duration) {
+		std::unique_lock lock(mSleepMutex);
+		mSleepCV.wait_for(lock, duration, [&]{
+			return mState.load(std::memory_order_relaxed) != RuntimeState::running;
+		});
 	}
 	
 	void CoreRuntime::setState(RuntimeState target) {
-		mState = target;
-		mCV.notify_one();
+		{
+			std::unique_lock lock(mSleepMutex);
+			mState.store(target, std::memory_order_release);
+		}
+		mSleepCV.notify_one();
+		mState.notify_one();
 	}
 
 }
@@ -3,7 +3,12 @@
 #include "Bloom/Core/Base.hpp"
 #include "Bloom/Core/Time.hpp"
 #include "Bloom/Application/CoreSystem.hpp"
+#include "Bloom/Application/InputEvent.hpp"
 
+#include <utl/vector.hpp>
+#include <atomic>
+#include <iosfwd>
+#include <span>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -12,8 +17,16 @@
 
 namespace bloom {
 
+	class ReplayWriter;
+	
 	struct BLOOM_API UpdateOptions {
+		/// Rate of the fixed simulation step. Zero steps as fast as possible with a variable timestep,
+		/// yielding the thread between steps.
 		std::size_t stepsPerSecond = 50;
+		
+		/// Maximum number of steps run back to back to catch up after a stall. Time beyond that is dropped,
+		/// so the simulation slows down instead of spiraling when steps take longer than real time.
+		std::size_t maxCatchUpSteps = 5;
 	};
 	
 	enum class BLOOM_API RuntimeState {
@@ -28,12 +41,14 @@ namespace bloom {
 		virtual void stop() {};
 		virtual void pause() {};
 		virtual void resume() {};
+		/// Input events submitted since the previous step, delivered right before the next step.
+		virtual void input(std::span<InputEvent const>) {};
 		virtual void step(Timestep) {};
 	};
 	
     class BLOOM_API CoreRuntime: public CoreSystem {
     public:
-		CoreRuntime() = default;
+		CoreRuntime();
 		explicit CoreRuntime(std::shared_ptr<RuntimeDelegate>);
 		
 		~CoreRuntime();
@@ -41,33 +56,82 @@ namespace bloom {
 		void init();
 		
 		/// MARK: Queries
-		UpdateOptions updateOptions() const { return mUpdateOptions; }
-		RuntimeState state() const { return mState; }
+		/// Queries never lock and may be called from any thread.
+		UpdateOptions updateOptions() const;
+		RuntimeState state() const { return mState.load(std::memory_order_acquire); }
+		
+		/// Fraction of a step that has elapsed since the last simulation step, in [0, 1].
+		/// Rendering can blend between the last two simulation states with it.
+		double interpolationAlpha() const;
 		
 		/// MARK: Modifiers
 		void setDelegate(std::shared_ptr<RuntimeDelegate>);
-		void setUpdateOptions(UpdateOptions options) { mUpdateOptions = options; }
+		/// Takes effect at the next iteration of the update thread.
+		void setUpdateOptions(UpdateOptions options);
 		
+		/// State changes are thread safe. They are serialized among each other but never wait for a running step,
+		/// except \p stop(), which joins the update thread. Must not be called from the delegate.
 		void run();
 		void stop();
 		void pause();
 		void resume();
 		
+		/// Queues \p event for delivery to the delegate before the next step. Thread safe.
+		void submitInput(InputEvent const& event);
+		
+		/// MARK: Recording
+		/// Records the timestep and input of every step to \p stream, which must outlive the recording.
+		/// Only possible while inactive, so that replays start from the same state as the recording.
+		void startRecording(std::ostream& stream);
+		/// Terminates the replay stream.
+		void stopRecording();
+		bool isRecording() const;
+		
 	private:
 		/// MARK: Private
+		using Clock = std::chrono::steady_clock;
+		
+		/// The step loop reads the state atomically and never locks while running.
+		/// It waits on \p mState while paused and on \p mSleepCV until the next fixed step is due.
 		void updateThread();
+		void runStep(Timestep);
+		/// Sleeps for at most \p duration, returns early if the state changes.
+		void sleep(Clock::duration duration);
 		void setState(RuntimeState target);
 		
     private:
 		std::thread mUpdateThread;
-		std::mutex mMutex;
-		std::condition_variable mCV;
+		/// Serializes state changes and recording. Never taken by the update thread.
+		mutable std::mutex mControlMutex;
+		/// Only held to go to sleep until the next step and to publish a state change, so no wakeup is lost.
+		std::mutex mSleepMutex;
+		std::condition_variable mSleepCV;
 		
-		RuntimeState mState = RuntimeState::inactive;
+		std::atomic<RuntimeState> mState = RuntimeState::inactive;
+		/// Only accessed by the update thread.
 		Timer mTimer;
-		UpdateOptions mUpdateOptions;
+		std::atomic_size_t mStepsPerSecond = UpdateOptions{}.stepsPerSecond;
+		std::atomic_size_t mMaxCatchUpSteps = UpdateOptions{}.maxCatchUpSteps;
+		
+		/// Ticks of \p Clock. Wall clock time at which the simulation was exactly caught up.
+		std::atomic<Clock::rep> mStepReference = 0;
+		std::atomic<Clock::rep> mPauseTime = 0;
+		std::atomic<Clock::rep> mStepDuration = 0;
 		
 		std::shared_ptr<RuntimeDelegate> mDelegate;
+		
+		/// Checked by every step, so the step loop only locks \p mInputMutex if there is input.
+		std::atomic_bool mHasPendingInput = false;
+		std::mutex mInputMutex;
+		/// Guarded by \p mInputMutex.
+		utl::vector<InputEvent> mPendingInput;
+		/// Only accessed by the update thread.
+		utl::vector<InputEvent> mStepInput;
+		
+		/// Cleared by \p stopRecording(). The update thread releases \p mRecorder before its next step.
+		std::atomic_bool mRecording = false;
+		/// Only accessed by the update thread while active.
+		std::unique_ptr<ReplayWriter> mRecorder;
     };
 
 }
@@ -0,0 +1,57 @@
+#include "JobSystem.hpp"
+
+namespace bloom {
+	
+	JobSystem::JobSystem(std::size_t workerCount):
+		mThreadPool(workerCount)
+	{
+		
+	}
+	
+	void JobSystem::submit(utl::function<void()> job) {
+		mPendingJobs.fetch_add(1, std::memory_order_relaxed);
+		mThreadPool.submit([this, job = std::move(job)]{
+			job();
+			mPendingJobs.fetch_sub(1, std::memory_order_release);
+		});
+	}
+	
+	void JobSystem::submit(utl::function<void()> job, utl::function<void()> continuation) {
+		submit([this, job = std::move(job), continuation = std::move(continuation)]() mutable {
+			job();
+			dispatchToMainThread(std::move(continuation));
+		});
+	}
+	
+	void JobSystem::parallelFor(std::size_t count, std::size_t grainSize,
+								utl::function<void(std::size_t, std::size_t)> const& function)
+	{
+		mThreadPool.parallelFor(count, grainSize, function);
+	}
+	
+	void JobSystem::run(TaskGraph& graph) {
+		graph.run(mThreadPool);
+	}
+	
+	void JobSystem::waitIdle() {
+		mThreadPool.wait(mPendingJobs);
+	}
+	
+	void JobSystem::dispatchToMainThread(utl::function<void()> function) {
+		std::unique_lock lock(mMainThreadMutex);
+		mMainThreadTasks.push_back(std::move(function));
+	}
+	
+	void JobSystem::runMainThreadTasks() {
+		utl::vector<utl::function<void()>> tasks;
+		{
+			std::unique_lock lock(mMainThreadMutex);
+			std::swap(tasks, mMainThreadTasks);
+		}
+		// Functions dispatched from within these run next frame.
+		for (auto& task: tasks) {
+			task();
+		}
+	}
+	
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Bloom/Core/Base.hpp"
+#include "Bloom/Core/TaskGraph.hpp"
+#include "Bloom/Core/ThreadPool.hpp"
+#include "Bloom/Application/CoreSystem.hpp"
+
+#include <utl/functional.hpp>
+#include <utl/vector.hpp>
+#include <atomic>
+#include <mutex>
+
+namespace bloom {
+	
+	/// Shared scheduler for work that can be spread across threads.
+	/// Systems should use it instead of spawning threads of their own.
+	class BLOOM_API JobSystem: public CoreSystem {
+	public:
+		explicit JobSystem(std::size_t workerCount = ThreadPool::defaultWorkerCount());
+		
+		ThreadPool& threadPool() { return mThreadPool; }
+		std::size_t workerCount() const { return mThreadPool.workerCount(); }
+		
+		/// MARK: Jobs
+		/// Runs \p job on some worker. Thread safe.
+		void submit(utl::function<void()> job);
+		
+		/// Runs \p job on some worker and afterwards \p continuation on the main thread. Thread safe.
+		void submit(utl::function<void()> job, utl::function<void()> continuation);
+		
+		/// See \p ThreadPool::parallelFor().
+		void parallelFor(std::size_t count, std::size_t grainSize,
+						 utl::function<void(std::size_t, std::size_t)> const& function);
+		
+		/// Runs \p graph on the workers and returns once all of its tasks have completed.
+		void run(TaskGraph& graph);
+		
+		/// Returns once all jobs submitted so far have completed. The calling thread helps processing them.
+		void waitIdle();
+		
+		/// MARK: Main thread
+		/// Queues \p function to run on the main thread at the beginning of the next frame. Thread safe.
+		void dispatchToMainThread(utl::function<void()> function);
+		
+		/// Runs the functions dispatched to the main thread so far. Called by the application every frame.
+		void runMainThreadTasks();
+	
+	private:
+		std::atomic_size_t mPendingJobs = 0;
+		std::mutex mMainThreadMutex;
+		utl::vector<utl::function<void()>> mMainThreadTasks;
+		/// Declared last so the queued jobs drain before anything they may use is destroyed.
+		ThreadPool mThreadPool;
+	};
+	
+}
@@ -0,0 +1,160 @@
+#include "Replay.hpp"
+
+#include "CoreRuntime.hpp"
+
+#include "Bloom/Core/Debug.hpp"
+
+#include <utl/format.hpp>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace bloom {
+	
+	/// MARK: Format
+	static constexpr std::uint32_t replayMagic = 0x504C5242; // "BRLP"
+	static constexpr std::uint32_t replayVersion = 1;
+	
+	enum class RecordTag: std::uint8_t {
+		end = 0, step = 1
+	};
+	
+	/// Alternatives an \p InputEvent can hold, indexed in the stream.
+	using InputEventTypes = std::tuple<MouseEvent, MouseDownEvent, MouseUpEvent, MouseMoveEvent,
+									   MouseDragEvent, ScrollEvent, MagnificationEvent, KeyEvent>;
+	
+	template <typename E, std::size_t... I>
+	static constexpr std::uint8_t eventIndex(std::index_sequence<I...>) {
+		std::uint8_t result = 0;
+		((std::is_same_v<E, std::tuple_element_t<I, InputEventTypes>> ? (result = I, true) : false) || ...);
+		return result;
+	}
+	
+	template <typename T>
+	static void write(std::ostream& stream, T const& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		stream.write(reinterpret_cast<char const*>(&value), sizeof value);
+	}
+	
+	template <typename T>
+	static T read(std::istream& stream) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		T value;
+		stream.read(reinterpret_cast<char*>(&value), sizeof value);
+		if (!stream) {
+			throw std::runtime_error("Replay stream is truncated");
+		}
+		return value;
+	}
+	
+	template <std::size_t... I>
+	static InputEvent readEvent(std::istream& stream, InputEventType type, std::uint8_t index, std::index_sequence<I...>) {
+		std::optional<InputEvent> result;
+		((index == I ? (result.emplace(type, read<std::tuple_element_t<I, InputEventTypes>>(stream)), true) : false) || ...);
+		if (!result) {
+			throw std::runtime_error("Replay stream contains an unknown input event");
+		}
+		return *result;
+	}
+	
+	/// MARK: ReplayWriter
+	ReplayWriter::ReplayWriter(std::ostream& stream, ReplayHeader header):
+		mStream(&stream)
+	{
+		write(stream, replayMagic);
+		write(stream, replayVersion);
+		write(stream, header.stepsPerSecond);
+	}
+	
+	ReplayWriter::~ReplayWriter() {
+		finish();
+	}
+	
+	void ReplayWriter::writeStep(Timestep timestep, std::span<InputEvent const> input) {
+		bloomExpect(!mFinished);
+		write(*mStream, RecordTag::step);
+		write(*mStream, timestep.absolute);
+		write(*mStream, timestep.delta);
+		write(*mStream, static_cast<std::uint32_t>(input.size()));
+		for (auto const& event: input) {
+			write(*mStream, event.type());
+			event.visit([&](auto const& e) {
+				using E = std::decay_t<decltype(e)>;
+				write(*mStream, eventIndex<E>(std::make_index_sequence<std::tuple_size_v<InputEventTypes>>{}));
+				write(*mStream, e);
+			});
+		}
+		++mStepCount;
+	}
+	
+	void ReplayWriter::finish() {
+		if (mFinished) {
+			return;
+		}
+		write(*mStream, RecordTag::end);
+		mStream->flush();
+		mFinished = true;
+	}
+	
+	/// MARK: ReplayReader
+	ReplayReader::ReplayReader(std::istream& stream):
+		mStream(&stream)
+	{
+		if (read<std::uint32_t>(stream) != replayMagic) {
+			throw std::runtime_error("Stream is not a replay");
+		}
+		if (auto const version = read<std::uint32_t>(stream); version != replayVersion) {
+			throw std::runtime_error(utl::format("Unsupported replay version {}", version));
+		}
+		mHeader.stepsPerSecond = read<std::uint32_t>(stream);
+	}
+	
+	bool ReplayReader::next(ReplayStep& step) {
+		if (mFinished) {
+			return false;
+		}
+		switch (read<RecordTag>(*mStream)) {
+			case RecordTag::end:
+				mFinished = true;
+				return false;
+			
+			case RecordTag::step:
+				break;
+			
+			default:
+				throw std::runtime_error("Replay stream is corrupt");
+		}
+		step.timestep.absolute = read<double>(*mStream);
+		step.timestep.delta = read<double>(*mStream);
+		std::size_t const eventCount = read<std::uint32_t>(*mStream);
+		step.input.clear();
+		for (std::size_t i = 0; i < eventCount; ++i) {
+			auto const type = read<InputEventType>(*mStream);
+			auto const index = read<std::uint8_t>(*mStream);
+			step.input.push_back(readEvent(*mStream, type, index,
+										   std::make_index_sequence<std::tuple_size_v<InputEventTypes>>{}));
+		}
+		return true;
+	}
+	
+	/// MARK: Headless Replay
+	ReplayStatistics replay(ReplayReader& reader, RuntimeDelegate& delegate) {
+		ReplayStatistics result;
+		ReplayStep step;
+		auto const begin = std::chrono::steady_clock::now();
+		delegate.start();
+		while (reader.next(step)) {
+			delegate.input(step.input);
+			delegate.step(step.timestep);
+			++result.stepCount;
+		}
+		delegate.stop();
+		result.duration = std::chrono::steady_clock::now() - begin;
+		return result;
+	}
+	
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Bloom/Core/Base.hpp"
+#include "Bloom/Core/Time.hpp"
+#include "Bloom/Application/InputEvent.hpp"
+
+#include <utl/vector.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+
+namespace bloom {
+	
+	class RuntimeDelegate;
+	
+	/// Replays are binary streams of simulation steps, each with the timestep passed to the delegate
+	/// and the input events delivered right before it. Events are stored in their in-memory layout,
+	/// so replays are only portable between builds of the same version on the same platform.
+	/// Replaying reproduces a recording as long as it starts from the same scenes.
+	struct BLOOM_API ReplayHeader {
+		/// Fixed step rate of the recording, zero if it used a variable timestep.
+		std::uint32_t stepsPerSecond = 0;
+	};
+	
+	struct BLOOM_API ReplayStep {
+		Timestep timestep{};
+		utl::vector<InputEvent> input;
+	};
+	
+	class BLOOM_API ReplayWriter {
+	public:
+		/// Writes the header right away. \p stream must be opened in binary mode and outlive the writer.
+		explicit ReplayWriter(std::ostream& stream, ReplayHeader header = {});
+		ReplayWriter(ReplayWriter const&) = delete;
+		ReplayWriter& operator=(ReplayWriter const&) = delete;
+		/// Calls \p finish() if it has not been called.
+		~ReplayWriter();
+		
+		void writeStep(Timestep, std::span<InputEvent const> input);
+		
+		/// Terminates the stream. No steps may be written afterwards.
+		void finish();
+		
+		std::size_t stepCount() const { return mStepCount; }
+	
+	private:
+		std::ostream* mStream;
+		std::size_t mStepCount = 0;
+		bool mFinished = false;
+	};
+	
+	class BLOOM_API ReplayReader {
+	public:
+		/// Reads the header. Throws \p std::runtime_error if \p stream does not contain a replay of this version.
+		explicit ReplayReader(std::istream& stream);
+		
+		ReplayHeader header() const { return mHeader; }
+		
+		/// Reads the next step into \p step. Returns false once the end of the replay is reached.
+		/// Throws \p std::runtime_error if the stream is truncated or corrupt.
+		bool next(ReplayStep& step);
+	
+	private:
+		std::istream* mStream;
+		ReplayHeader mHeader;
+		bool mFinished = false;
+	};
+	
+	struct BLOOM_API ReplayStatistics {
+		std::size_t stepCount = 0;
+		/// Wall clock time spent in the delegate.
+		std::chrono::nanoseconds duration{};
+	};
+	
+	/// Runs the steps of \p reader on \p delegate back to back on the calling thread, without waiting for
+	/// the recorded timesteps to elapse and without any window. Calls \p start() before and \p stop() after the steps.
+	BLOOM_API ReplayStatistics replay(ReplayReader& reader, RuntimeDelegate& delegate);
+	
+}
@@ -2,28 +2,65 @@
 
 #include "Bloom/Scene/Scene.hpp"
 
-#include <utl/stack.hpp>
+#include <utl/scope_guard.hpp>
+#include <algorithm>
+#include <utility>
 
 namespace bloom {
 	
+	SceneSystem::SceneSystem():
+		mOwnedThreadPool(std::make_unique<ThreadPool>()),
+		mThreadPool(mOwnedThreadPool.get())
+	{
+		addBuiltinSystems();
+	}
+	
+	SceneSystem::SceneSystem(ThreadPool& threadPool):
+		mThreadPool(&threadPool)
+	{
+		addBuiltinSystems();
+	}
+	
+	SceneSystem::~SceneSystem() {
+		{
+			std::unique_lock lock(mStreamMutex);
+			for (auto&& [id, stream]: mStreams) {
+				stream->cancelled = true;
+			}
+		}
+		mThreadPool->wait(mRunningStreamJobs);
+	}
+	
 	void SceneSystem::loadScene(Reference<Scene> scene) {
-		auto const [_, success] = mScenes.insert({ scene->handle().id(), std::move(scene) });
+		utl::UUID const id = scene->handle().id();
+		std::unique_lock lock(mMutex);
+		auto const [itr, success] = mScenes.insert({ id, std::move(scene) });
 		if (!success) {
 			bloomLog(error, "Failed to load scene. Scene is already loaded.");
 			return;
 		}
+		if (mSimulating) {
+			mBackupScenes.insert({ id, allocateRef<Scene>(itr->second->copy()) });
+			mSimChanges.push_back({ id, itr->second });
+		}
 		setPointers();
 	}
 	
 	void SceneSystem::unloadScene(utl::UUID id) {
 		auto const itr = mScenes.find(id);
-		auto* const scene = itr->second.get();
 		if (itr == mScenes.end()) {
 			bloomLog(error, "Failed to unload scene. Scene was not loaded.");
 			return;
 		}
-		mScenes.erase(itr);
-		dispatch(DispatchToken::now, UnloadSceneEvent{ .scene = scene });
+		Reference<Scene> const scene = itr->second;
+		{
+			std::unique_lock lock(mMutex);
+			mScenes.erase(itr);
+			if (mSimulating) {
+				mSimChanges.push_back({ id, nullptr });
+			}
+		}
+		dispatch(DispatchToken::now, UnloadSceneEvent{ .scene = scene.get() });
 		setPointers();
 	}
 	
@@ -31,7 +68,15 @@ namespace bloom {
 		for (auto&& [key, scene]: mScenes) {
 			dispatch(DispatchToken::now, UnloadSceneEvent{ .scene = scene.get() });
 		}
-		mScenes.clear();
+		{
+			std::unique_lock lock(mMutex);
+			if (mSimulating) {
+				for (auto&& [id, scene]: mScenes) {
+					mSimChanges.push_back({ id, nullptr });
+				}
+			}
+			mScenes.clear();
+		}
 		setPointers();
 	}
 	
@@ -39,44 +84,75 @@ namespace bloom {
 		return std::unique_lock(mMutex);
 	}
 	
+	static void applyTransformHierarchy(std::span<Scene* const> scenes,
+										TransformHierarchyOptions options,
+										ThreadPool* threadPool)
+	{
+		if (!options.threadPool) {
+			options.threadPool = threadPool;
+		}
+		for (auto scene: scenes) {
+			scene->applyTransformHierarchy(options);
+		}
+	}
+	
 	void SceneSystem::applyTransformHierarchy() {
-		for (auto scene: scenes()) {
-			auto view = scene->view<Transform const, TransformMatrixComponent>();
-			view.each([&](auto const id, Transform const& transform, TransformMatrixComponent& transformMatrix) {
-				transformMatrix.matrix = transform.calculate();
-			});
-
-			utl::stack<EntityID> stack(scene->gatherRoots());
-
-			while (stack) {
-				auto const current = stack.pop();
-				auto const& currentTransform = scene->getComponent<TransformMatrixComponent>(current);
-
-				auto const children = scene->gatherChildren(current);
-				for (auto const c: children) {
-					auto& childTransform = scene->getComponent<TransformMatrixComponent>(c);
-					childTransform.matrix = currentTransform.matrix * childTransform.matrix;
-					stack.push(c);
-				}
-			}
+		bloom::applyTransformHierarchy(scenes(), mTransformHierarchyOptions, mThreadPool);
+	}
+	
+	std::size_t SceneSystem::transformWorkerCount() const {
+		return mThreadPool->workerCount();
+	}
+	
+	void SceneSystem::setTransformWorkerCount(std::size_t count) {
+		if (count == transformWorkerCount()) {
+			return;
 		}
+		// Stream reads are queued on the current pool and would be lost with it,
+		// or never run at all if it is a shared pool without workers.
+		mThreadPool->wait(mRunningStreamJobs);
+		mOwnedThreadPool = std::make_unique<ThreadPool>(count);
+		mThreadPool = mOwnedThreadPool.get();
 	}
 	
 	void SceneSystem::start() {
 		std::unique_lock lock(mMutex);
+		mSimulating = true;
+		mSimChanges.clear();
 		mBackupScenes.clear();
-		mBackupScenes.insert(mScenes.begin(), mScenes.end());
+		for (auto&& [id, scene]: mScenes) {
+			mBackupScenes.insert({ id, allocateRef<Scene>(scene->copy()) });
+		}
 		
 		mSimScenes.clear();
 		mSimScenes.insert(mScenes.begin(), mScenes.end());
+		mSimScenePtrs.clear();
+		for (auto&& [id, scene]: mSimScenes) {
+			mSimScenePtrs.push_back(scene.get());
+		}
+		mStepCount = 0;
+		// Give the renderer something to draw before the first step.
+		publishRenderSnapshot();
 	}
 	
 	void SceneSystem::stop() {
 		std::unique_lock lock(mMutex);
+		mSimulating = false;
+		mSimChanges.clear();
 		mSimScenes.clear();
-		mScenes.clear();
-		mScenes.insert(mBackupScenes.begin(), mBackupScenes.end());
-		setPointers();
+		mSimScenePtrs.clear();
+		
+		// Scenes unloaded or streamed out while simulating stay unloaded, their backups are dropped.
+		// Scenes loaded or streamed in while simulating were backed up when they were added.
+		for (auto&& [id, scene]: mScenes) {
+			auto const itr = mBackupScenes.find(id);
+			if (itr == mBackupScenes.end()) {
+				continue;
+			}
+			// Restore in place, so pointers to the scene and handles to its entities stay valid.
+			*scene = std::move(*itr->second);
+		}
+		mBackupScenes.clear();
 	}
 	
 	void SceneSystem::pause() {
@@ -87,29 +163,52 @@ namespace bloom {
 		
 	}
 	
-	void SceneSystem::step(Timestep) {
-		tryCopyOut();
-		
+	void SceneSystem::addBuiltinSystems() {
+		mSystems.add(SystemDescription("Demo Motion")
+			.writes<Transform>()
+			.run([](Scene& scene, Timestep) {
+				for (auto&& [id, transform]: scene.view<Transform>().each()) {
+					transform.position.x += 0.01;
+					scene.markTransformDirty(id);
+					break;
+				}
+			}));
+	}
+	
+	void SceneSystem::input(std::span<InputEvent const> events) {
+		mStepInput.clear();
+		for (auto const& event: events) {
+			mStepInput.push_back(event);
+		}
+	}
+	
+	void SceneSystem::step(Timestep timestep) {
+		utl::scope_guard clearInput = [this]{ mStepInput.clear(); };
+		bool const streamed = applySimulationStreaming();
 		if (mSimScenes.empty()) {
+			if (streamed) {
+				// The last scene was streamed out, the renderer must not keep drawing it.
+				publishRenderSnapshot();
+			}
 			return;
 		}
 		
-		for (auto const& [id, scene]: mSimScenes) {
-			for (auto&& [id, transform]: scene->view<Transform>().each()) {
-				transform.position.x += 0.01;
-				break;
-			}
-		}
+		mSystems.run(mSimScenePtrs, timestep, mThreadPool);
+		
+		++mStepCount;
+		publishRenderSnapshot();
 	}
 	
-	void SceneSystem::tryCopyOut() {
-		std::unique_lock lock(mMutex, std::try_to_lock);
-		if (!lock) {
-			return;
+	void SceneSystem::publishRenderSnapshot() {
+		bloom::applyTransformHierarchy(mSimScenePtrs, mTransformHierarchyOptions, mThreadPool);
+		
+		RenderSnapshot& snapshot = mRenderSnapshots.back();
+		snapshot.clear();
+		for (Scene const* scene: mSimScenePtrs) {
+			snapshot.extract(*scene);
 		}
-		mScenes.clear();
-		mScenes.insert(mSimScenes.begin(), mSimScenes.end());
-		setPointers();
+		snapshot.step = mStepCount;
+		mRenderSnapshots.publish();
 	}
 
 	void SceneSystem::setPointers() {
@@ -119,4 +218,204 @@ namespace bloom {
 					   [](auto&& p) { return p.second.get(); });
 	}
 	
+	/// MARK: Streaming
+	SceneSystem::StreamID SceneSystem::streamScene(Reference<Scene> scene, int priority) {
+		bloomExpect(scene != nullptr);
+		if (!mSceneReader) {
+			bloomLog(error, "Failed to stream scene. No scene reader is set.");
+			return 0;
+		}
+		StreamID const id = mNextStreamID++;
+		auto stream = std::make_unique<SceneStream>();
+		stream->target = std::move(scene);
+		stream->priority = priority;
+		{
+			std::unique_lock lock(mStreamMutex);
+			mStreams.insert({ id, std::move(stream) });
+		}
+		startStreams();
+		return id;
+	}
+	
+	void SceneSystem::setStreamPriority(StreamID id, int priority) {
+		std::unique_lock lock(mStreamMutex);
+		auto const itr = mStreams.find(id);
+		if (itr != mStreams.end() && !itr->second->started) {
+			itr->second->priority = priority;
+		}
+	}
+	
+	bool SceneSystem::cancelStream(StreamID id) {
+		std::unique_lock lock(mStreamMutex);
+		auto const itr = mStreams.find(id);
+		if (itr == mStreams.end() || itr->second->cancelled) {
+			return false;
+		}
+		if (!itr->second->started) {
+			mStreams.erase(itr);
+			return true;
+		}
+		// The reader cannot be interrupted. The result is discarded by update().
+		itr->second->cancelled = true;
+		return true;
+	}
+	
+	void SceneSystem::streamOutScene(utl::UUID id) {
+		mStreamOuts.push_back(id);
+	}
+	
+	std::size_t SceneSystem::pendingStreamCount() const {
+		std::unique_lock lock(mStreamMutex);
+		return std::count_if(mStreams.begin(), mStreams.end(), [](auto&& p) { return !p.second->cancelled; });
+	}
+	
+	void SceneSystem::setMaxConcurrentStreams(std::size_t count) {
+		bloomExpect(count > 0);
+		mMaxConcurrentStreams = count;
+		startStreams();
+	}
+	
+	void SceneSystem::update() {
+		if (mThreadPool->workerCount() == 0) {
+			// Nobody else runs the reads.
+			while (mThreadPool->tryRunTask()) {}
+		}
+		
+		utl::vector<std::pair<Reference<Scene>, Scene>> streamedIn;
+		{
+			std::unique_lock lock(mStreamMutex);
+			utl::vector<StreamID> finished;
+			for (auto&& [id, stream]: mStreams) {
+				if (!stream->finished) {
+					continue;
+				}
+				if (!stream->cancelled && stream->result) {
+					streamedIn.push_back({ std::move(stream->target), std::move(*stream->result) });
+				}
+				finished.push_back(id);
+			}
+			for (StreamID const id: finished) {
+				mStreams.erase(id);
+			}
+		}
+		for (auto&& [target, scene]: streamedIn) {
+			addStreamedScene(std::move(target), std::move(scene));
+		}
+		
+		bool const changed = !streamedIn.empty() || !mStreamOuts.empty();
+		for (utl::UUID const id: std::exchange(mStreamOuts, {})) {
+			auto const itr = mScenes.find(id);
+			if (itr == mScenes.end()) {
+				bloomLog(error, "Failed to stream out scene. Scene was not loaded.");
+				continue;
+			}
+			Reference<Scene> scene = std::move(itr->second);
+			{
+				std::unique_lock lock(mMutex);
+				mScenes.erase(itr);
+				if (mSimulating) {
+					mSimChanges.push_back({ id, nullptr });
+				}
+			}
+			dispatch(DispatchToken::now, UnloadSceneEvent{ .scene = scene.get() });
+			// Destroying a large registry takes a while. If the simulation still holds the scene, it lets go of it the same way.
+			mThreadPool->submit([scene = std::move(scene)]() mutable { scene.reset(); });
+		}
+		
+		if (changed) {
+			setPointers();
+		}
+		startStreams();
+	}
+	
+	void SceneSystem::startStreams() {
+		std::unique_lock lock(mStreamMutex);
+		while (mActiveStreams < mMaxConcurrentStreams) {
+			SceneStream* next = nullptr;
+			StreamID nextID = 0;
+			for (auto&& [id, stream]: mStreams) {
+				if (stream->started) {
+					continue;
+				}
+				if (!next || stream->priority > next->priority || (stream->priority == next->priority && id < nextID)) {
+					next = stream.get();
+					nextID = id;
+				}
+			}
+			if (!next) {
+				return;
+			}
+			next->started = true;
+			++mActiveStreams;
+			mRunningStreamJobs.fetch_add(1, std::memory_order_relaxed);
+			mThreadPool->submit([this, next]{ readStream(*next); });
+		}
+	}
+	
+	void SceneSystem::readStream(SceneStream& stream) {
+		bool cancelled;
+		{
+			std::unique_lock lock(mStreamMutex);
+			cancelled = stream.cancelled;
+		}
+		std::optional<Scene> result;
+		if (!cancelled) {
+			try {
+				result = mSceneReader(stream.target->handle());
+			}
+			catch (std::exception const& e) {
+				bloomLog(error, "Failed to stream scene: {}", e.what());
+			}
+		}
+		{
+			std::unique_lock lock(mStreamMutex);
+			stream.result = std::move(result);
+			stream.finished = true;
+			--mActiveStreams;
+		}
+		mRunningStreamJobs.fetch_sub(1, std::memory_order_release);
+	}
+	
+	void SceneSystem::addStreamedScene(Reference<Scene> target, Scene scene) {
+		utl::UUID const id = target->handle().id();
+		if (mScenes.find(id) != mScenes.end()) {
+			bloomLog(error, "Failed to stream in scene. Scene is already loaded.");
+			return;
+		}
+		// Moves the registry, entities are not touched one by one.
+		*target = std::move(scene);
+		std::unique_lock lock(mMutex);
+		if (mSimulating) {
+			// Restored like the other scenes when the simulation stops.
+			mBackupScenes.insert({ id, allocateRef<Scene>(target->copy()) });
+			mSimChanges.push_back({ id, target });
+		}
+		mScenes.insert({ id, std::move(target) });
+	}
+	
+	bool SceneSystem::applySimulationStreaming() {
+		std::unique_lock lock(mMutex);
+		if (mSimChanges.empty()) {
+			return false;
+		}
+		for (auto&& [id, scene]: mSimChanges) {
+			if (scene) {
+				mSimScenes.insert({ id, std::move(scene) });
+				continue;
+			}
+			auto const itr = mSimScenes.find(id);
+			if (itr == mSimScenes.end()) {
+				continue;
+			}
+			mThreadPool->submit([scene = std::move(itr->second)]() mutable { scene.reset(); });
+			mSimScenes.erase(itr);
+		}
+		mSimChanges.clear();
+		mSimScenePtrs.clear();
+		for (auto&& [id, scene]: mSimScenes) {
+			mSimScenePtrs.push_back(scene.get());
+		}
+		return true;
+	}
+	
 }
@@ -1,13 +1,24 @@
 #pragma once
 
 #include "CoreRuntime.hpp"
+#include "SystemScheduler.hpp"
+
+#include "Bloom/Scene/Scene.hpp"
 
 #include "Bloom/Core/Base.hpp"
 #include "Bloom/Core/Reference.hpp"
+#include "Bloom/Core/ThreadPool.hpp"
+#include "Bloom/Core/TripleBuffer.hpp"
+#include "Bloom/Graphics/Renderer/RenderSnapshot.hpp"
 #include "Bloom/Application/CoreSystem.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <span>
+#include <utl/functional.hpp>
 #include <utl/hashmap.hpp>
 #include <utl/UUID.hpp>
 #include <utl/utility.hpp>
@@ -18,24 +29,100 @@ namespace bloom {
 	
 	class BLOOM_API SceneSystem: public CoreSystem, public RuntimeDelegate {
 	public:
+		/// Uses a thread pool of its own.
+		SceneSystem();
+		/// Shares \p threadPool, which must outlive the scene system.
+		explicit SceneSystem(ThreadPool& threadPool);
+		/// Waits for scenes that are still being streamed in.
+		~SceneSystem();
+		
 		void loadScene(Reference<Scene>);
 		void unloadScene(utl::UUID id);
 		void unloadAll();
 		std::unique_lock<std::mutex> lock();
 		std::span<Scene* const> scenes() const { return mScenePtrs; }
+		
+		TransformHierarchyOptions transformHierarchyOptions() const { return mTransformHierarchyOptions; }
+		void setTransformHierarchyOptions(TransformHierarchyOptions options) { mTransformHierarchyOptions = options; }
 		void applyTransformHierarchy();
 		
+		/// Number of threads besides the calling thread used to update the transform hierarchy.
+		/// Defaults to the workers of the shared thread pool. Setting a different count gives the
+		/// scene system a pool of its own and waits for the scenes being read on the old one. Zero disables the parallel update.
+		std::size_t transformWorkerCount() const;
+		void setTransformWorkerCount(std::size_t count);
+		
+		/// Systems run on the simulated scenes every step. Must not be modified while simulating.
+		SystemScheduler& systems() { return mSystems; }
+		
+		/// Input events delivered right before the current step, recorded and replayed along with the timesteps.
+		/// Systems read them while running, e.g. by capturing the scene system. Empty outside of a step.
+		std::span<InputEvent const> stepInput() const { return mStepInput; }
+		
+		/// Latest render state published by the simulation. Never blocks the caller or the simulation thread.
+		/// Only a single thread, usually the render thread, may call this. The result stays valid until the next call.
+		RenderSnapshot const& renderSnapshot() { return mRenderSnapshots.consume(); }
+		
+		/// MARK: Streaming
+		/// Scenes can be streamed in and out additively without stalling the frame. Streamed scenes are read on a
+		/// worker thread into a scene of their own and moved into the scene asset by \p update(), so the only work
+		/// left for the main thread is a registry move. A running simulation picks them up before its next step.
+		/// Stopping the simulation restores the scenes that are still loaded, including those streamed in meanwhile.
+		/// Streaming functions must be called on the main thread.
+		using StreamID = std::uint64_t;
+		
+		/// Reads a scene on a worker thread. The core system manager reads scenes through the asset manager.
+		using SceneReader = utl::function<std::optional<Scene>(AssetHandle)>;
+		void setSceneReader(SceneReader reader) { mSceneReader = std::move(reader); }
+		
+		/// Loads the content of \p scene in the background and adds the scene once it is read.
+		/// Requests with a higher \p priority start first, equal priorities in the order they were made.
+		StreamID streamScene(Reference<Scene> scene, int priority = 0);
+		
+		/// Changes the priority of a request that has not started reading yet.
+		void setStreamPriority(StreamID id, int priority);
+		
+		/// Discards a request. A scene that is being read is dropped once reading finishes.
+		/// Returns false if the scene was already added or \p id is unknown.
+		bool cancelStream(StreamID id);
+		
+		/// Unloads the scene at the next \p update() and destroys it on a worker thread.
+		void streamOutScene(utl::UUID id);
+		
+		/// Number of stream requests that have neither been added nor cancelled yet.
+		std::size_t pendingStreamCount() const;
+		
+		/// Upper bound of scenes read at the same time. Defaults to one, so a single large scene cannot starve the workers.
+		std::size_t maxConcurrentStreams() const { return mMaxConcurrentStreams; }
+		void setMaxConcurrentStreams(std::size_t count);
+		
+		/// Adds the streamed scenes that finished reading, unloads the streamed out ones and starts the next requests.
+		/// Called by the application at the beginning of every frame.
+		void update();
+		
 	private:
 		void start() override;
 		void stop() override;
 		void pause() override;
 		void resume() override;
 		
+		void input(std::span<InputEvent const>) override;
 		void step(Timestep) override;
 		
-		void tryCopyOut();
+		void addBuiltinSystems();
+		
+		/// Updates the world transforms of the simulated scenes and publishes their render state.
+		void publishRenderSnapshot();
 		void setPointers();
 		
+		struct SceneStream;
+		void startStreams();
+		void readStream(SceneStream&);
+		void addStreamedScene(Reference<Scene> target, Scene scene);
+		/// Applies scenes streamed in or out while simulating. Runs on the simulation thread before every step.
+		/// Returns true if the simulated scenes changed.
+		bool applySimulationStreaming();
+		
 	private:
 //		std::mutex writeMutex, readMutex;
 		std::mutex mMutex;
@@ -43,6 +130,36 @@ namespace bloom {
 		utl::hashmap<utl::UUID, Reference<Scene>> mSimScenes;
 		utl::hashmap<utl::UUID, Reference<Scene>> mScenes;
 		utl::vector<Scene*> mScenePtrs;
+		TransformHierarchyOptions mTransformHierarchyOptions;
+		std::unique_ptr<ThreadPool> mOwnedThreadPool;
+		ThreadPool* mThreadPool = nullptr;
+		SystemScheduler mSystems;
+		TripleBuffer<RenderSnapshot> mRenderSnapshots;
+		utl::vector<Scene*> mSimScenePtrs;
+		utl::vector<InputEvent> mStepInput;
+		std::size_t mStepCount = 0;
+		bool mSimulating = false;
+		
+		/// MARK: Streaming
+		struct SceneStream {
+			Reference<Scene> target;
+			int priority = 0;
+			bool started = false;
+			bool finished = false;
+			bool cancelled = false;
+			std::optional<Scene> result;
+		};
+		SceneReader mSceneReader;
+		/// Guards \p mStreams while reads are running.
+		mutable std::mutex mStreamMutex;
+		utl::hashmap<StreamID, std::unique_ptr<SceneStream>> mStreams;
+		StreamID mNextStreamID = 1;
+		std::size_t mActiveStreams = 0;
+		std::size_t mMaxConcurrentStreams = 1;
+		std::atomic_size_t mRunningStreamJobs = 0;
+		utl::vector<utl::UUID> mStreamOuts;
+		/// Scenes added to (non-null) and removed from (null) the simulation before its next step. Guarded by \p mMutex.
+		utl::vector<std::pair<utl::UUID, Reference<Scene>>> mSimChanges;
 	};
 	
 	struct BLOOM_API UnloadSceneEvent {
@@ -25,6 +25,8 @@ namespace {
 	
 	Transform& getTransform(ScriptObject& obj) {
 		auto handle = boxed_cast<EntityHandle>(obj.get_attr("__bloomEntity"));
+		// Scripts receive a mutable reference, so we have to assume they write to it.
+		handle.scene().markTransformDirty(handle);
 		return handle.get<Transform>();
 	}
 	
@@ -142,38 +144,63 @@ namespace bloom {
 		}
 	}
 	
-	void ScriptSystem::onSceneConstruction() {
+	void ScriptSystem::loadFunctions() {
 		auto& engine = *mEngine;
 		initFn  = engine.eval<std::function<void(ScriptObject&)>>("init");
 		updateFn  = engine.eval<std::function<void(ScriptObject&, Timestep)>>("update");
 		renderFn  = engine.eval<std::function<void(ScriptObject&)>>("render");
-		
-		forEach([&](EntityID id, ScriptComponent& script) {
-			executeGuarded([&]{
-				script.hasUpdateFn = std::nullopt;
-				script.hasRenderFn = std::nullopt;
-				
-				std::map<std::string, chaiscript::Boxed_Value> oldFields = script.object ?
-					script.object->get_attrs() : decltype(script.object->get_attrs()){};
-				
-				script.object = engine.instanciateObject(script.className);
-				copyFields(*script.object, oldFields);
-#warning
-//				script.object->get_attr("__bloomEntity") = chaiscript::Boxed_Value(sceneSystem->_scene->getHandle(id));
-			}, script.className, script.className);
+	}
+	
+	bool ScriptSystem::construct(Scene& scene, EntityID id, ScriptComponent& script) {
+		return executeGuarded([&]{
+			script.hasUpdateFn = std::nullopt;
+			script.hasRenderFn = std::nullopt;
+			
+			std::map<std::string, chaiscript::Boxed_Value> oldFields = script.object ?
+				script.object->get_attrs() : decltype(script.object->get_attrs()){};
+			
+			script.object = mEngine->instanciateObject(script.className);
+			copyFields(*script.object, oldFields);
+			script.object->get_attr("__bloomEntity") = chaiscript::Boxed_Value(scene.getHandle(id));
+		}, script.className, script.className);
+	}
+	
+	void ScriptSystem::onSceneConstruction(Scene& scene) {
+		loadFunctions();
+		forEach(scene, [&](EntityID id, ScriptComponent& script) {
+			construct(scene, id, script);
 		});
 	}
 	
-	void ScriptSystem::onSceneInit() {
-		forEach([&](ScriptComponent& script) {
+	void ScriptSystem::onSceneInit(Scene& scene) {
+		forEach(scene, [&](ScriptComponent& script) {
+			if (!script.object) {
+				return;
+			}
 			executeGuarded([&]{
 				initFn(*script.object);
 			}, script.className, "init");
 		});
 	}
 	
-	void ScriptSystem::onSceneUpdate(Timestep t) {
-		forEach([&](ScriptComponent& script) {
+	void ScriptSystem::onSceneUpdate(Scene& scene, Timestep t) {
+		if (!updateFn) {
+			loadFunctions();
+		}
+		forEach(scene, [&](EntityID id, ScriptComponent& script) {
+			if (!script.object && !script.hasUpdateFn) {
+				if (!construct(scene, id, script)) {
+					// Don't retry and report the failure every step.
+					script.hasUpdateFn = false;
+					return;
+				}
+				executeGuarded([&]{
+					initFn(*script.object);
+				}, script.className, "init");
+			}
+			if (!script.object) {
+				return;
+			}
 			if UTL_LIKELY (script.hasUpdateFn) {
 				if (*script.hasUpdateFn) {
 					updateFn(*script.object, t);
@@ -187,8 +214,11 @@ namespace bloom {
 		});
 	}
 	
-	void ScriptSystem::onSceneRender() {
-		forEach([&](ScriptComponent& script) {
+	void ScriptSystem::onSceneRender(Scene& scene) {
+		forEach(scene, [&](ScriptComponent& script) {
+			if (!script.object) {
+				return;
+			}
 			if UTL_LIKELY (script.hasRenderFn) {
 				if (*script.hasRenderFn) {
 					renderFn(*script.object);
@@ -202,26 +232,32 @@ namespace bloom {
 		});
 	}
 	
+	SystemDescription ScriptSystem::updateSystem() {
+		return SystemDescription("Scripts")
+			.exclusive()
+			.run([this](Scene& scene, Timestep t) {
+				onSceneUpdate(scene, t);
+			});
+	}
+	
 	void ScriptSystem::onScriptReload() {
 //		if (sceneSystem && sceneSystem->_scene) {
 //			onSceneConstruction();
 //		}
 	}
 	
-	void ScriptSystem::forEach(auto&& fn) {
-//		bloomExpect(sceneSystem && sceneSystem->_scene);
-//
-//		sceneSystem->_scene->view<ScriptComponent>().each([&](auto id, ScriptComponent& script) {
-//			if constexpr (std::invocable<decltype(fn), ScriptComponent&>) {
-//				fn(script);
-//			}
-//			else if constexpr (std::invocable<decltype(fn), EntityID, ScriptComponent&>) {
-//				fn(EntityID{ id }, script);
-//			}
-//			else {
-//				static_assert(utl::template_false<decltype(fn)>);
-//			}
-//		});
+	void ScriptSystem::forEach(Scene& scene, auto&& fn) {
+		scene.view<ScriptComponent>().each([&](auto id, ScriptComponent& script) {
+			if constexpr (std::invocable<decltype(fn), ScriptComponent&>) {
+				fn(script);
+			}
+			else if constexpr (std::invocable<decltype(fn), EntityID, ScriptComponent&>) {
+				fn(EntityID{ id }, script);
+			}
+			else {
+				static_assert(utl::template_false<decltype(fn)>);
+			}
+		});
 	}
 	
 
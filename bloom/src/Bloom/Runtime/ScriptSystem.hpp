@@ -2,24 +2,34 @@
 
 #include "Bloom/Core/Time.hpp"
 #include "Bloom/Application/CoreSystem.hpp"
+#include "Bloom/Runtime/SystemScheduler.hpp"
 #include "Bloom/ScriptEngine/ScriptEngine.hpp"
 
 namespace bloom {
 	
+	struct ScriptComponent;
+	
     class ScriptSystem: public CoreSystem {
     public:
 		ScriptSystem(ScriptEngine&);
 		void init();
 		
-		void onSceneConstruction();
-		void onSceneInit();
-		void onSceneUpdate(Timestep);
-		void onSceneRender();
+		void onSceneConstruction(Scene&);
+		void onSceneInit(Scene&);
+		/// Instantiates and initializes scripts that have no object yet before updating them,
+		/// so scenes streamed in while simulating need no construction of their own.
+		void onSceneUpdate(Scene&, Timestep);
+		void onSceneRender(Scene&);
+		
+		/// Updates the scripts of the simulated scenes. Scripts may access anything, so the system is exclusive.
+		SystemDescription updateSystem();
 		
 	private:
 		void onScriptReload();
 		
-		void forEach(auto&& fn);
+		void loadFunctions();
+		bool construct(Scene&, EntityID, ScriptComponent&);
+		void forEach(Scene&, auto&& fn);
 		
     private:
 		ScriptEngine* mEngine = nullptr;
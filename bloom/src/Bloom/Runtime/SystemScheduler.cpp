@@ -0,0 +1,93 @@
+#include "SystemScheduler.hpp"
+
+#include "Bloom/Core/Debug.hpp"
+#include "Bloom/Core/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace bloom {
+	
+	static bool intersects(std::span<entt::id_type const> a, std::span<entt::id_type const> b) {
+		return std::any_of(a.begin(), a.end(), [&](entt::id_type id) {
+			return std::find(b.begin(), b.end(), id) != b.end();
+		});
+	}
+	
+	bool SystemDescription::conflictsWith(SystemDescription const& other) const {
+		if (mExclusive || other.mExclusive) {
+			return true;
+		}
+		return intersects(mWrites, other.mWrites) ||
+			intersects(mWrites, other.mReads) ||
+			intersects(mReads, other.mWrites);
+	}
+	
+	SystemScheduler::SystemID SystemScheduler::add(SystemDescription system) {
+		bloomExpect(!!system.mFunction, "System needs a function to run");
+		mSystems.push_back(std::move(system));
+		mDirty = true;
+		return mSystems.size() - 1;
+	}
+	
+	void SystemScheduler::clear() {
+		mSystems.clear();
+		mDirty = true;
+	}
+	
+	std::span<std::pair<SystemScheduler::SystemID, SystemScheduler::SystemID> const> SystemScheduler::dependencies() {
+		if (mDirty) {
+			build();
+		}
+		return mDependencies;
+	}
+	
+	void SystemScheduler::build() {
+		mDependencies.clear();
+		mGraph.clear();
+		for (SystemID id = 0; id < mSystems.size(); ++id) {
+			mGraph.add([this, id]{ runSystem(id); });
+		}
+		for (SystemID after = 0; after < mSystems.size(); ++after) {
+			for (SystemID before = 0; before < after; ++before) {
+				if (mSystems[before].conflictsWith(mSystems[after])) {
+					mDependencies.push_back({ before, after });
+					mGraph.precede(before, after);
+				}
+			}
+		}
+		mDirty = false;
+	}
+	
+	void SystemScheduler::run(std::span<Scene* const> scenes, Timestep timestep, ThreadPool* threadPool) {
+		if (mDirty) {
+			build();
+		}
+		for (Scene* scene: scenes) {
+			for (auto& system: mSystems) {
+				for (auto& prepare: system.mPrepare) {
+					prepare(*scene);
+				}
+			}
+		}
+		
+		mScenes = scenes;
+		mTimestep = timestep;
+		if (threadPool) {
+			mGraph.run(*threadPool);
+		}
+		else {
+			for (SystemID id = 0; id < mSystems.size(); ++id) {
+				runSystem(id);
+			}
+		}
+		mScenes = {};
+	}
+	
+	void SystemScheduler::runSystem(SystemID id) {
+		auto& function = mSystems[id].mFunction;
+		for (Scene* scene: mScenes) {
+			function(*scene, mTimestep);
+		}
+	}
+	
+}
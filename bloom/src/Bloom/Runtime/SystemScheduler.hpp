@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Bloom/Core/Base.hpp"
+#include "Bloom/Core/TaskGraph.hpp"
+#include "Bloom/Core/Time.hpp"
+#include "Bloom/Scene/Scene.hpp"
+
+#include <entt/entt.hpp>
+#include <utl/functional.hpp>
+#include <utl/vector.hpp>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace bloom {
+	
+	class ThreadPool;
+	
+	using SystemFunction = utl::function<void(Scene&, Timestep)>;
+	
+	namespace internal {
+		
+		/// Stand-in for the state \p Scene keeps in its registry context and updates from component signals,
+		/// i.e. the cached world transforms, the hierarchy order, the name index and the spatial index.
+		struct SceneSignalState;
+		
+		/// Components whose signals touch \p SceneSignalState, see \p Scene::connectSignals().
+		template <typename Component>
+		inline constexpr bool hasSceneSignals =
+			std::is_same_v<Component, Transform> ||
+			std::is_same_v<Component, HierarchyComponent> ||
+			std::is_same_v<Component, TagComponent> ||
+			std::is_same_v<Component, MeshRendererComponent>;
+		
+	}
+	
+	/// A system updating scenes, together with the component types it accesses.
+	///
+	/// 	SystemDescription("Animation")
+	/// 		.reads<Animator>()
+	/// 		.writes<Transform>()
+	/// 		.run([](Scene& scene, Timestep t) { ... });
+	///
+	/// Scheduled systems may only access the components they declare and must not create or destroy entities
+	/// or add or remove components of any other type, unless declared \p exclusive().
+	/// Writing a \p Transform adds a \p TransformDirtyTag, so declaring it implies writing the tag as well.
+	/// Accessing a \p Transform, \p HierarchyComponent, \p TagComponent or \p MeshRendererComponent also accesses
+	/// the state the scene maintains from their signals, so systems accessing any of them are serialized
+	/// unless all of them only read.
+	class BLOOM_API SystemDescription {
+	public:
+		explicit SystemDescription(std::string name): mName(std::move(name)) {}
+		
+		template <typename... Components>
+		SystemDescription& reads() {
+			(add<Components>(mReads), ...);
+			return *this;
+		}
+		
+		template <typename... Components>
+		SystemDescription& writes() {
+			(addWrite<Components>(), ...);
+			return *this;
+		}
+		
+		/// The system may change the structure of the scene arbitrarily and never runs concurrently with another system.
+		SystemDescription& exclusive() {
+			mExclusive = true;
+			return *this;
+		}
+		
+		SystemDescription& run(SystemFunction function) {
+			mFunction = std::move(function);
+			return *this;
+		}
+		
+		std::string_view name() const { return mName; }
+		bool isExclusive() const { return mExclusive; }
+		
+		/// True if the two systems must not run at the same time.
+		bool conflictsWith(SystemDescription const& other) const;
+	
+	private:
+		friend class SystemScheduler;
+		
+		template <typename Component>
+		void add(utl::vector<entt::id_type>& set) {
+			set.push_back(entt::type_hash<Component>::value());
+			mPrepare.push_back([](Scene& scene) { scene.view<Component>(); });
+			if constexpr (internal::hasSceneSignals<Component>) {
+				set.push_back(entt::type_hash<internal::SceneSignalState>::value());
+			}
+		}
+		
+		template <typename Component>
+		void addWrite() {
+			add<Component>(mWrites);
+			if constexpr (std::is_same_v<Component, Transform>) {
+				add<TransformDirtyTag>(mWrites);
+			}
+		}
+	
+	private:
+		std::string mName;
+		utl::vector<entt::id_type> mReads, mWrites;
+		bool mExclusive = false;
+		SystemFunction mFunction;
+		/// Creates the component pools up front, since creating a pool modifies the registry.
+		utl::vector<utl::function<void(Scene&)>> mPrepare;
+	};
+	
+	/// Runs a set of systems on scenes. Systems whose accesses conflict run in the order they were added,
+	/// all others may run in parallel.
+	class BLOOM_API SystemScheduler {
+	public:
+		using SystemID = std::size_t;
+		
+		SystemID add(SystemDescription system);
+		void clear();
+		
+		std::size_t size() const { return mSystems.size(); }
+		SystemDescription const& system(SystemID id) const { return mSystems[id]; }
+		
+		/// Pairs (before, after) of systems that conflict, in the order they run.
+		std::span<std::pair<SystemID, SystemID> const> dependencies();
+		
+		/// Runs every system once on each of \p scenes. Systems run in parallel on \p threadPool if not null.
+		/// Systems must not be added while running.
+		void run(std::span<Scene* const> scenes, Timestep, ThreadPool* threadPool);
+	
+	private:
+		void build();
+		void runSystem(SystemID);
+	
+	private:
+		utl::vector<SystemDescription> mSystems;
+		utl::vector<std::pair<SystemID, SystemID>> mDependencies;
+		TaskGraph mGraph;
+		bool mDirty = false;
+		
+		/// Arguments of the current run, read by the tasks of \p mGraph.
+		std::span<Scene* const> mScenes;
+		Timestep mTimestep{};
+	};
+	
+}
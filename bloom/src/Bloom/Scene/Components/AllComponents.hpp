@@ -6,6 +6,7 @@
 #include "Hierarchy.hpp"
 #include "Lights.hpp"
 #include "Script.hpp"
+#include "PrefabInstance.hpp"
 
 #include <tuple>
 
@@ -21,7 +22,8 @@ namespace bloom {
 		SpotLightComponent,
 		DirectionalLightComponent,
 		SkyLightComponent,
-		ScriptComponent
+		ScriptComponent,
+		PrefabInstanceComponent
 	>;
 
 	template <typename...T>
@@ -18,8 +18,9 @@ namespace bloom {
 		materialInstance = as<MaterialInstance>(assetManager.get(matHandle));
 		mesh = as<StaticMesh>(assetManager.get(meshHandle));
 	
-		assetManager.makeAvailable(matHandle, AssetRepresentation::GPU);
-		assetManager.makeAvailable(meshHandle, AssetRepresentation::GPU);
+		// Renderers skip the mesh until both have arrived.
+		assetManager.makeAvailableAsync(matHandle, AssetRepresentation::GPU);
+		assetManager.makeAvailableAsync(meshHandle, AssetRepresentation::GPU);
 	}
 	
 }
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ComponentBase.hpp"
+
+#include "Bloom/Core/Reference.hpp"
+#include "Bloom/Scene/Entity.hpp"
+
+#include <utl/vector.hpp>
+
+namespace bloom {
+	
+	class Prefab;
+	
+	/// Sits on the root of an instance of \p prefab.
+	struct BLOOM_API PrefabInstanceComponent {
+		BLOOM_REGISTER_COMPONENT("Prefab Instance");
+		
+		Reference<Prefab> prefab;
+		/// Entities of the instance, in the order of \p Prefab::entities(). The first one is the root.
+		utl::vector<EntityID> entities;
+	};
+	
+}
@@ -2,14 +2,15 @@
 
 #include "ComponentBase.hpp"
 
-#include <string>
+#include "Bloom/Core/InternedString.hpp"
 
 namespace bloom {
 	
 	struct BLOOM_API TagComponent {
 		BLOOM_REGISTER_COMPONENT("Tag");
 		
-		std::string name;
+		/// Interned in the string table of the scene, so tags are pointer sized and copying them does not allocate.
+		InternedString name;
 	};
 	
 }
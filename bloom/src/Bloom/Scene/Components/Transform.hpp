@@ -28,6 +28,10 @@ namespace bloom {
 		mtl::float4x4 matrix;
 	};
 	
+	/// Attached by the scene to every entity whose \p Transform changed since the last hierarchy update.
+	/// Not a registered component, so it is neither serialized nor copied.
+	struct BLOOM_API TransformDirtyTag {};
+	
 }
 
 #ifdef BLOOM_CPP
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Bloom/Core/Base.hpp"
+
+#include "Components/Hierarchy.hpp"
+#include "Entity.hpp"
+
+#include <entt/entt.hpp>
+#include <iterator>
+
+namespace bloom {
+	
+	/// Iterates the children of an entity by walking the circular sibling list in place.
+	class BLOOM_API ChildIterator {
+	public:
+		using value_type        = EntityID;
+		using reference         = EntityID;
+		using pointer           = void;
+		using difference_type   = std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+		
+		ChildIterator() = default;
+		ChildIterator(entt::registry const* registry, EntityID first, EntityID last):
+			mRegistry(registry),
+			mCurrent(first),
+			mLast(last)
+		{}
+		
+		EntityID operator*() const { return mCurrent; }
+		
+		ChildIterator& operator++() {
+			mCurrent = mCurrent == mLast ?
+				EntityID{} : mRegistry->get<HierarchyComponent>(mCurrent.value()).nextSibling;
+			return *this;
+		}
+		
+		ChildIterator operator++(int) {
+			auto result = *this;
+			++*this;
+			return result;
+		}
+		
+		friend bool operator==(ChildIterator const& a, ChildIterator const& b) {
+			return a.mCurrent == b.mCurrent;
+		}
+	
+	private:
+		entt::registry const* mRegistry = nullptr;
+		EntityID mCurrent, mLast;
+	};
+	
+	/// Iterates the hierarchy pool and skips every entity that has a parent.
+	class BLOOM_API RootIterator {
+		using BaseIterator = decltype(std::declval<entt::registry const&>().view<HierarchyComponent const>().begin());
+	
+	public:
+		using value_type        = EntityID;
+		using reference         = EntityID;
+		using pointer           = void;
+		using difference_type   = std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+		
+		RootIterator() = default;
+		RootIterator(entt::registry const* registry, BaseIterator itr, BaseIterator end):
+			mRegistry(registry),
+			mItr(itr),
+			mEnd(end)
+		{
+			skipChildren();
+		}
+		
+		EntityID operator*() const { return *mItr; }
+		
+		RootIterator& operator++() {
+			++mItr;
+			skipChildren();
+			return *this;
+		}
+		
+		RootIterator operator++(int) {
+			auto result = *this;
+			++*this;
+			return result;
+		}
+		
+		friend bool operator==(RootIterator const& a, RootIterator const& b) {
+			return a.mItr == b.mItr;
+		}
+	
+	private:
+		void skipChildren() {
+			while (mItr != mEnd && mRegistry->get<HierarchyComponent>(*mItr).parent) {
+				++mItr;
+			}
+		}
+	
+	private:
+		entt::registry const* mRegistry = nullptr;
+		BaseIterator mItr, mEnd;
+	};
+	
+	/// Lightweight, non-owning range of entities. Does not allocate.
+	template <typename Iterator>
+	class EntityRange {
+	public:
+		EntityRange(Iterator begin, Iterator end):
+			mBegin(begin),
+			mEnd(end)
+		{}
+		
+		Iterator begin() const { return mBegin; }
+		Iterator end() const { return mEnd; }
+		
+		bool empty() const { return mBegin == mEnd; }
+	
+	private:
+		Iterator mBegin, mEnd;
+	};
+	
+}
@@ -0,0 +1,36 @@
+#include "Prefab.hpp"
+
+namespace bloom {
+	
+	Prefab::Prefab(AssetHandle handle, std::string name):
+		Asset(handle, name),
+		mScene(handle, std::move(name))
+	{}
+	
+	void Prefab::setTemplate(Scene const& scene, EntityID root) {
+		bloomExpect(!scene.hasComponent<PrefabInstanceComponent>(root), "The root of a prefab can not be an instance");
+		mScene = Scene(handle(), std::string(name()));
+		mEntities = mScene.copyEntities(scene, scene.gatherSubtree(root));
+	}
+	
+	/// MARK: Serialize
+	YAML::Node Prefab::serialize() const {
+		YAML::Node node;
+		if (!mEntities.empty()) {
+			node["Root"] = mEntities.front();
+			node["Entities"] = mScene.serialize();
+		}
+		return node;
+	}
+	
+	void Prefab::deserialize(YAML::Node const& node, AssetManager& assetManager) {
+		mScene = Scene(handle(), std::string(name()));
+		mEntities.clear();
+		if (!node["Root"].IsDefined()) {
+			return;
+		}
+		mScene.deserialize(node["Entities"], assetManager);
+		mEntities = mScene.gatherSubtree(node["Root"].as<EntityID>());
+	}
+	
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Bloom/Core/Base.hpp"
+#include "Bloom/Asset/Asset.hpp"
+
+#include "Scene.hpp"
+
+#include <span>
+#include <utl/vector.hpp>
+#include <yaml-cpp/yaml.h>
+
+namespace bloom {
+	
+	class AssetManager;
+	
+	/// Template of an entity subtree. \p Scene::instantiate() spawns copies of it, which scenes save
+	/// as their differences to the prefab.
+	class BLOOM_API Prefab: public Asset {
+	public:
+		explicit Prefab(AssetHandle handle, std::string name);
+		
+		/// Replaces the template with a copy of \p root and its descendants in \p scene.
+		/// The copied root is detached from its parent and keeps its local transform.
+		void setTemplate(Scene const& scene, EntityID root);
+		
+		/// Holds the components every instance is copied from.
+		Scene const& scene() const { return mScene; }
+		
+		/// Entities of the template, the root first followed by its descendants in depth first order.
+		std::span<EntityID const> entities() const { return mEntities; }
+		
+		/// MARK: Serialize
+		YAML::Node serialize() const;
+		void deserialize(YAML::Node const&, AssetManager&);
+	
+	private:
+		Scene mScene;
+		utl::vector<EntityID> mEntities;
+	};
+	
+}
@@ -1,18 +1,221 @@
 #include "Scene.hpp"
 
 #include "Bloom/Core/Debug.hpp"
+#include "Bloom/Core/ThreadPool.hpp"
+#include "Bloom/Core/YAMLStream.hpp"
+#include "Bloom/Asset/AssetManager.hpp"
 
 #include "Components/Tag.hpp"
 #include "Components/Transform.hpp"
 #include "Components/Hierarchy.hpp"
+#include "Components/MeshRenderer.hpp"
+#include "Components/PrefabInstance.hpp"
+#include "Prefab.hpp"
+#include "TransformKernels.hpp"
 
 #include <utl/stack.hpp>
+#include <utl/vector.hpp>
 #include <utl/format.hpp>
 #include <utl/hashmap.hpp>
 #include <yaml-cpp/helpers.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <utility>
 
 namespace bloom {
 	
+	Scene::Scene(AssetHandle handle, std::string name):
+		Asset(handle, std::move(name))
+	{
+		connectSignals();
+	}
+	
+	namespace {
+		/// Lives in the registry context, so it moves along with the registry.
+		struct HierarchyOrderState {
+			bool sorted = false;
+		};
+		
+		/// Per entity result of \p Scene::gatherDirtyRoots(), only valid for entries stamped with the current \p pass.
+		/// Lives in the registry context as well.
+		struct DirtyRootState {
+			struct Visit {
+				std::uint32_t pass = 0;
+				bool dirtyAncestor = false;
+			};
+			
+			std::uint32_t pass = 0;
+			utl::vector<Visit> visits;
+		};
+		
+		/// Tracks which \p TransformMatrixComponent hold the current world matrix of their entity, indexed by entity.
+		/// Filled by \p Scene::applyTransformHierarchy() and cleared for the whole subtree when a transform or a parent
+		/// changes. A valid entity always has a valid parent, so invalidation stops at entities that already are invalid.
+		/// Lives in the registry context as well.
+		struct WorldTransformCache {
+			bool isValid(entt::entity entity) const {
+				std::size_t const index = entt::to_entity(entity);
+				return index < valid.size() && valid[index];
+			}
+			
+			void setValid(entt::entity entity, bool value) {
+				std::size_t const index = entt::to_entity(entity);
+				if (index >= valid.size()) {
+					if (!value) {
+						return;
+					}
+					valid.resize(index + 1, 0);
+				}
+				valid[index] = value;
+			}
+			
+			/// Invalidates \p entity and all of its descendants.
+			void invalidate(entt::registry const& registry, entt::entity entity) {
+				utl::stack<entt::entity> stack;
+				stack.push(entity);
+				while (stack) {
+					entt::entity const current = stack.pop();
+					if (!isValid(current)) {
+						continue;
+					}
+					setValid(current, false);
+					forEachChild(registry, current, [&](entt::entity child) { stack.push(child); });
+				}
+			}
+			
+			/// Marks \p root and all of its descendants as valid, as long as the parent of \p root is.
+			void validate(entt::registry const& registry, entt::entity root) {
+				auto const* const hierarchy = registry.try_get<HierarchyComponent>(root);
+				if (hierarchy && hierarchy->parent && !isValid(hierarchy->parent.value())) {
+					return;
+				}
+				utl::stack<entt::entity> stack;
+				stack.push(root);
+				while (stack) {
+					entt::entity const current = stack.pop();
+					setValid(current, true);
+					forEachChild(registry, current, [&](entt::entity child) { stack.push(child); });
+				}
+			}
+			
+			/// Links of freshly copied components may still point into another subtree,
+			/// so only children that refer back to \p parent are visited.
+			static void forEachChild(entt::registry const& registry, entt::entity parent, auto&& f) {
+				auto const* const hierarchy = registry.try_get<HierarchyComponent>(parent);
+				if (!hierarchy || !hierarchy->firstChild) {
+					return;
+				}
+				EntityID child = hierarchy->firstChild;
+				do {
+					if (!registry.valid(child.value())) {
+						return;
+					}
+					auto const* const childHierarchy = registry.try_get<HierarchyComponent>(child.value());
+					if (!childHierarchy || childHierarchy->parent.value() != parent) {
+						return;
+					}
+					f(child.value());
+					child = childHierarchy->nextSibling;
+				} while (child && child != hierarchy->firstChild);
+			}
+			
+			utl::vector<std::uint8_t> valid;
+		};
+		
+		/// Maps names to the entities carrying them. Lives in the registry context as well.
+		/// Lookups still verify every candidate against its current tag, as tags may be replaced without \p Scene::setName().
+		struct NameIndex {
+			utl::hashmap<InternedString, utl::small_vector<entt::entity>> entities;
+		};
+		
+		/// World bounds of mesh entities. Lives in the registry context as well.
+		struct SpatialIndexState {
+			SpatialIndex::ProxyID& proxy(entt::entity entity) {
+				std::size_t const index = entt::to_entity(entity);
+				if (index >= proxies.size()) {
+					proxies.resize(index + 1, SpatialIndex::nullProxy);
+				}
+				return proxies[index];
+			}
+			
+			SpatialIndex index;
+			/// Proxy of every entity in \p index, indexed by entity.
+			utl::vector<SpatialIndex::ProxyID> proxies;
+			/// Entities whose mesh changed or whose mesh bounds are not known yet.
+			utl::vector<entt::entity> pending;
+		};
+	}
+	
+	static void markTransformDirtySignal(entt::registry& registry, entt::entity entity) {
+		registry.emplace_or_replace<TransformDirtyTag>(entity);
+		registry.ctx().at<WorldTransformCache>().invalidate(registry, entity);
+	}
+	
+	static void invalidateHierarchyOrderSignal(entt::registry& registry, entt::entity entity) {
+		registry.ctx().at<HierarchyOrderState>().sorted = false;
+		registry.ctx().at<WorldTransformCache>().invalidate(registry, entity);
+	}
+	
+	static void addToNameIndexSignal(entt::registry& registry, entt::entity entity) {
+		auto& tag = registry.get<TagComponent>(entity);
+		// Names are moved into the table of the scene they end up in, wherever the component was created.
+		registry.ctx().at<StringTable>().adopt(tag.name);
+		auto& candidates = registry.ctx().at<NameIndex>().entities[tag.name];
+		if (std::find(candidates.begin(), candidates.end(), entity) == candidates.end()) {
+			candidates.push_back(entity);
+		}
+	}
+	
+	static void markBoundsDirtySignal(entt::registry& registry, entt::entity entity) {
+		registry.ctx().at<SpatialIndexState>().pending.push_back(entity);
+	}
+	
+	static void removeFromSpatialIndexSignal(entt::registry& registry, entt::entity entity) {
+		auto& state = registry.ctx().at<SpatialIndexState>();
+		auto& proxy = state.proxy(entity);
+		if (proxy != SpatialIndex::nullProxy) {
+			state.index.remove(proxy);
+			proxy = SpatialIndex::nullProxy;
+		}
+	}
+	
+	static void removeFromNameIndexSignal(entt::registry& registry, entt::entity entity) {
+		auto& index = registry.ctx().at<NameIndex>().entities;
+		auto const itr = index.find(registry.get<TagComponent>(entity).name);
+		if (itr == index.end()) {
+			return;
+		}
+		auto& candidates = itr->second;
+		candidates.erase(std::remove(candidates.begin(), candidates.end(), entity), candidates.end());
+		if (candidates.empty()) {
+			index.erase(itr);
+		}
+	}
+	
+	void Scene::connectSignals() {
+		_registry.ctx().emplace<HierarchyOrderState>();
+		_registry.ctx().emplace<DirtyRootState>();
+		_registry.ctx().emplace<WorldTransformCache>();
+		_registry.ctx().emplace<StringTable>();
+		_registry.ctx().emplace<NameIndex>();
+		_registry.ctx().emplace<SpatialIndexState>();
+		
+		// Listeners are free functions so they stay valid when the registry is moved.
+		_registry.on_construct<Transform>().connect<&markTransformDirtySignal>();
+		_registry.on_update<Transform>().connect<&markTransformDirtySignal>();
+		_registry.on_construct<HierarchyComponent>().connect<&invalidateHierarchyOrderSignal>();
+		_registry.on_destroy<HierarchyComponent>().connect<&invalidateHierarchyOrderSignal>();
+		_registry.on_construct<TagComponent>().connect<&addToNameIndexSignal>();
+		_registry.on_update<TagComponent>().connect<&addToNameIndexSignal>();
+		_registry.on_destroy<TagComponent>().connect<&removeFromNameIndexSignal>();
+		_registry.on_construct<MeshRendererComponent>().connect<&markBoundsDirtySignal>();
+		_registry.on_update<MeshRendererComponent>().connect<&markBoundsDirtySignal>();
+		_registry.on_destroy<MeshRendererComponent>().connect<&removeFromSpatialIndexSignal>();
+	}
+	
 	EntityHandle Scene::createEmptyEntity() {
 		return createEmptyEntity(EntityHandle{});
 	}
@@ -26,12 +229,49 @@ namespace bloom {
 		EntityHandle const entity(_registry.create(), this);
 		entity.add(Transform{});
 		entity.add(TransformMatrixComponent{});
-		entity.add(TagComponent{ std::string(name) });
+		entity.add(TagComponent{ _registry.ctx().at<StringTable>().intern(name) });
 		entity.add(HierarchyComponent{});
 
 		return { entity, this };
 	}
 	
+	utl::vector<EntityID> Scene::createEntities(std::size_t count, std::string_view name) {
+		static_assert(sizeof(EntityID) == sizeof(entt::entity));
+		utl::vector<EntityID> result(count);
+		auto* const first = reinterpret_cast<entt::entity*>(result.data());
+		auto* const last = first + count;
+		_registry.create(first, last);
+		
+		auto reserve = [&]<typename T>(utl::tag<T>) {
+			auto& storage = _registry.storage<T>();
+			storage.reserve(storage.size() + count);
+		};
+		reserve(utl::tag<Transform>{});
+		reserve(utl::tag<TransformMatrixComponent>{});
+		reserve(utl::tag<TagComponent>{});
+		reserve(utl::tag<HierarchyComponent>{});
+		reserve(utl::tag<TransformDirtyTag>{});
+		
+		_registry.insert<Transform>(first, last);
+		_registry.insert<TransformMatrixComponent>(first, last);
+		_registry.insert<TagComponent>(first, last, TagComponent{ _registry.ctx().at<StringTable>().intern(name) });
+		_registry.insert<HierarchyComponent>(first, last);
+		
+		return result;
+	}
+	
+	void Scene::destroyEntities(std::span<EntityID const> entities) {
+		auto const* const first = reinterpret_cast<entt::entity const*>(entities.data());
+		auto const* const last = first + entities.size();
+		// Strip one pool at a time instead of visiting every pool once per entity.
+		for (auto&& [id, storage]: _registry.storage()) {
+			if (!storage.empty()) {
+				storage.remove(first, last);
+			}
+		}
+		_registry.release(first, last);
+	}
+	
 	EntityHandle Scene::cloneEntity(EntityID from) {
 		EntityHandle const result = createEmptyEntity();
 		
@@ -45,63 +285,181 @@ namespace bloom {
 		getComponent<HierarchyComponent>(result) = {};
 		auto const fromHierarchy = getComponent<HierarchyComponent>(from);
 		if (fromHierarchy.parent) {
-			parent(result, fromHierarchy.parent);
+			// The copied transform is already relative to the parent.
+			linkChild(result, fromHierarchy.parent);
 		}
 	
 		return result;
 	}
 	
-	void Scene::deleteEntity(EntityID id) {
-		_registry.destroy(id.value());
+	/// Appends copies of the components of \p sources[i] in \p from to \p targets[i] in \p to, one pool at a time.
+	template <typename T>
+	static void clonePool(entt::registry const& from, entt::registry& to,
+						  std::span<entt::entity const> sources, std::span<entt::entity const> targets)
+	{
+		auto const& source = from.storage<T>();
+		if (source.empty()) {
+			return;
+		}
+		utl::vector<entt::entity> entities;
+		// Copy the components out first, inserting into the pool may invalidate references into it.
+		utl::vector<T> components;
+		for (std::size_t i = 0; i < sources.size(); ++i) {
+			if (source.contains(sources[i])) {
+				entities.push_back(targets[i]);
+				components.push_back(source.get(sources[i]));
+			}
+		}
+		auto& target = to.storage<T>();
+		target.insert(entities.begin(), entities.end(), components.begin());
 	}
 	
-	Scene Scene::copy() {
-		utl::hashmap<EntityID, EntityID> idMap;
+	EntityHandle Scene::cloneSubtree(EntityID root) {
+		bloomExpect(hasComponent<HierarchyComponent>(root));
 		
-		Scene result(handle(), std::string(name()));
-		_registry.each([&](EntityID fromID) {
-			auto const fromHandle = this->getHandle(fromID);
-			EntityID const toID = result.createEmptyEntity(fromID);
-			auto const toHandle = result.getHandle(toID);
-			
-			idMap.insert({ fromID, toID });
-			forEachComponent([&]<typename C>(utl::tag<C>){
-				if (fromHandle.has<C>()) {
-					toHandle.add(fromHandle.get<C>());
-				}
-			});
+		auto const sources = gatherSubtree(root);
+		EntityID const parent = getComponent<HierarchyComponent>(root).parent;
+		EntityID const result = copyEntities(*this, sources).front();
+		if (parent) {
+			linkChild(result, parent);
+		}
+		
+#if BLOOM_DEBUGLEVEL
+		sanitizeHierachy(this);
+#endif
+		
+		return getHandle(result);
+	}
+	
+	utl::vector<EntityID> Scene::copyEntities(Scene const& source, std::span<EntityID const> entities,
+											  std::span<EntityID const> ids)
+	{
+		bloomExpect(ids.empty() || ids.size() == entities.size());
+		static_assert(sizeof(EntityID) == sizeof(entt::entity));
+		utl::vector<EntityID> result(entities.size());
+		auto* const first = reinterpret_cast<entt::entity*>(result.data());
+		if (ids.empty()) {
+			_registry.create(first, first + result.size());
+		}
+		else {
+			for (std::size_t i = 0; i < ids.size(); ++i) {
+				result[i] = _registry.create(ids[i].value());
+				bloomAssert(result[i] == ids[i], "ID is already in use");
+			}
+		}
+		
+		std::span const sources(reinterpret_cast<entt::entity const*>(entities.data()), entities.size());
+		std::span const targets(first, result.size());
+		forEachComponent([&]<typename C>(utl::tag<C>) {
+			clonePool<C>(source._registry, _registry, sources, targets);
 		});
 		
-		// copy hierarchy
-		for (auto [from, to]: idMap) {
-			if (from == to) {
-				continue;
+		// Point the copied links at the copies.
+		utl::hashmap<EntityID, EntityID> idMap;
+		for (std::size_t i = 0; i < entities.size(); ++i) {
+			idMap.insert({ entities[i], result[i] });
+		}
+		auto remap = [&](EntityID& link) {
+			if (!link) {
+				return;
 			}
-			bloomDebugbreak("Probably not going to happen");
-			auto fromHandle = this->getHandle(from);
-			auto toHandle = result.getHandle(to);
-			if (toHandle.has<HierarchyComponent>()) {
-				auto const& fromHierarchy = fromHandle.get<HierarchyComponent>();
-				auto& toHierarchy = toHandle.get<HierarchyComponent>();
-				
-				if (fromHierarchy.parent) {
-					toHierarchy.parent = idMap[fromHierarchy.parent];
-				}
-				if (fromHierarchy.firstChild) {
-					toHierarchy.firstChild = idMap[fromHierarchy.firstChild];
-				}
-				if (fromHierarchy.lastChild) {
-					toHierarchy.lastChild = idMap[fromHierarchy.lastChild];
-				}
-				if (fromHierarchy.nextSibling) {
-					toHierarchy.nextSibling = idMap[fromHierarchy.nextSibling];
+			auto const itr = idMap.find(link);
+			link = itr != idMap.end() ? itr->second : EntityID{};
+		};
+		for (EntityID const target: result) {
+			if (auto* const hierarchy = _registry.try_get<HierarchyComponent>(target.value())) {
+				remap(hierarchy->parent);
+				remap(hierarchy->prevSibling);
+				remap(hierarchy->nextSibling);
+				remap(hierarchy->firstChild);
+				remap(hierarchy->lastChild);
+				if (!hierarchy->parent) {
+					// Sibling lists are circular, a copied root may still refer to itself.
+					hierarchy->prevSibling = {};
+					hierarchy->nextSibling = {};
 				}
-				if (fromHierarchy.prevSibling) {
-					toHierarchy.prevSibling = idMap[fromHierarchy.prevSibling];
+			}
+			// Instances nested in the copied entities.
+			if (auto* const instance = _registry.try_get<PrefabInstanceComponent>(target.value())) {
+				for (EntityID& entity: instance->entities) {
+					remap(entity);
 				}
 			}
 		}
-		
+		invalidateHierarchyOrder();
+		return result;
+	}
+	
+	/// MARK: Prefabs
+	EntityHandle Scene::instantiate(Reference<Prefab> const& prefab, std::span<EntityID const> ids) {
+		bloomExpect(prefab && !prefab->entities().empty(), "Prefab is empty");
+		auto entities = copyEntities(prefab->scene(), prefab->entities(), ids);
+		EntityHandle const root = getHandle(entities.front());
+		root.add(PrefabInstanceComponent{ prefab, std::move(entities) });
+		return root;
+	}
+	
+	void Scene::setName(EntityID entity, std::string_view name) {
+		bloomExpect(hasComponent<TagComponent>(entity));
+		// The index holds on to the old name until the entity is removed from it.
+		removeFromNameIndexSignal(_registry, entity.value());
+		_registry.patch<TagComponent>(entity.value(), [&](TagComponent& tag) {
+			tag.name = _registry.ctx().at<StringTable>().intern(name);
+		});
+	}
+	
+	utl::small_vector<EntityID> Scene::findEntities(std::string_view name) const {
+		utl::small_vector<EntityID> result;
+		InternedString const key = _registry.ctx().at<StringTable>().find(name);
+		if (key.empty() && !name.empty()) { // not in the table, so no entity can carry this name
+			return result;
+		}
+		auto const& index = _registry.ctx().at<NameIndex>().entities;
+		auto const itr = index.find(key);
+		if (itr == index.end()) {
+			return result;
+		}
+		for (entt::entity const entity: itr->second) {
+			auto const* const tag = _registry.try_get<TagComponent>(entity);
+			if (tag && tag->name == key) {
+				result.push_back(entity);
+			}
+		}
+		return result;
+	}
+	
+	EntityID Scene::findEntity(std::string_view name) const {
+		auto const entities = findEntities(name);
+		return entities.empty() ? EntityID{} : entities.front();
+	}
+	
+	void Scene::deleteEntity(EntityID id) {
+		_registry.destroy(id.value());
+	}
+	
+	/// Copies the pool of \p T wholesale, keeping the order of its elements.
+	template <typename T>
+	static void copyPool(entt::registry const& from, entt::registry& to) {
+		auto const& source = from.storage<T>();
+		if (source.empty()) {
+			return;
+		}
+		auto& target = to.storage<T>();
+		target.reserve(source.size());
+		// data() lists the entities in packed order, the reverse iterators visit the components in the same order.
+		target.insert(source.data(), source.data() + source.size(), source.crbegin());
+	}
+	
+	Scene Scene::copy() const {
+		Scene result(handle(), std::string(name()));
+		result._registry.assign(_registry.data(), _registry.data() + _registry.size(), _registry.released());
+		// Copied before the tags, so the copy resolves their names by index instead of looking them up.
+		result._registry.ctx().at<StringTable>() = _registry.ctx().at<StringTable>().copy();
+		forEachComponent([&]<typename C>(utl::tag<C>) {
+			copyPool<C>(_registry, result._registry);
+		});
+		// Identifiers are preserved, so the index carries over as is.
+		result._registry.ctx().at<SpatialIndexState>() = _registry.ctx().at<SpatialIndexState>();
 		return result;
 	}
 	
@@ -136,6 +494,25 @@ namespace bloom {
 		}
 	}
 	
+	/// Entities of the instance that were deleted from \p scene are written as null.
+	static YAML::Node serializeInstance(Scene const& scene, PrefabInstanceComponent const& instance) {
+		YAML::Node node;
+		node["Prefab"] = instance.prefab->handle();
+		for (EntityID const entity: instance.entities) {
+			node["Entities"].push_back(scene.isValid(entity) ? entity : EntityID{});
+		}
+		return node;
+	}
+	
+	static void serializeComponent(YAML::Node& node, ConstEntityHandle entity, utl::tag<PrefabInstanceComponent>) {
+		if (entity.has<PrefabInstanceComponent>()) {
+			node[PrefabInstanceComponent::staticName()] = serializeInstance(entity.scene(), entity.get<PrefabInstanceComponent>());
+		}
+	}
+	
+	/// Instances are created by \p Scene::deserialize() before any entity is read.
+	static void deserializeComponent(YAML::Node const&, EntityHandle, AssetManager&, utl::tag<PrefabInstanceComponent>) {}
+	
 	static YAML::Node serializeEntity(Scene const& scene, EntityID id) {
 		YAML::Node node;
 		node["ID"] = id.raw();
@@ -157,11 +534,178 @@ namespace bloom {
 		});
 	}
 	
+	/// MARK: Prefab Overrides
+	static constexpr char const* removedComponentsKey = "Removed Components";
+	
+	/// Serializes \p instance.entities[index] as its differences to the corresponding entity of the prefab.
+	/// The node holds only the ID if the entity matches the prefab.
+	static YAML::Node serializeOverrides(Scene const& scene, PrefabInstanceComponent const& instance, std::size_t index) {
+		Prefab const& prefab = *instance.prefab;
+		EntityID const id = instance.entities[index];
+		YAML::Node const node = serializeEntity(scene, id);
+		
+		// The prefab refers to its own entities, compare as if it referred to the instance.
+		auto remap = [&](EntityID link) {
+			auto const itr = std::find(prefab.entities().begin(), prefab.entities().end(), link);
+			return itr != prefab.entities().end() ? instance.entities[itr - prefab.entities().begin()] : EntityID{};
+		};
+		auto const source = prefab.scene().getHandle(prefab.entities()[index]);
+		YAML::Node base = serializeEntity(prefab.scene(), source);
+		if (source.has<HierarchyComponent>()) {
+			auto hierarchy = source.get<HierarchyComponent>();
+			for (EntityID* link: { &hierarchy.parent, &hierarchy.prevSibling, &hierarchy.nextSibling,
+								   &hierarchy.firstChild, &hierarchy.lastChild })
+			{
+				*link = remap(*link);
+			}
+			base[HierarchyComponent::staticName()] = hierarchy;
+		}
+		if (source.has<PrefabInstanceComponent>()) {
+			auto nested = source.get<PrefabInstanceComponent>();
+			for (EntityID& entity: nested.entities) {
+				entity = remap(entity);
+			}
+			base[PrefabInstanceComponent::staticName()] = serializeInstance(scene, nested);
+		}
+		YAML::Node const& constBase = base;
+		
+		YAML::Node result;
+		result["ID"] = id.raw();
+		for (auto const& entry: node) {
+			auto const name = entry.first.as<std::string>();
+			if (name == "ID") {
+				continue;
+			}
+			YAML::Node const baseValue = constBase[name];
+			if (!baseValue.IsDefined() || YAML::Dump(baseValue) != YAML::Dump(entry.second)) {
+				result[name] = entry.second;
+			}
+		}
+		for (auto const& entry: constBase) {
+			auto const name = entry.first.as<std::string>();
+			if (name != "ID" && !node[name].IsDefined()) {
+				result[removedComponentsKey].push_back(name);
+			}
+		}
+		return result;
+	}
+	
+	/// Replaces the components of \p entity that \p node lists and removes the components listed as removed.
+	static void deserializeOverrides(YAML::Node const& node, EntityHandle entity, AssetManager& assetManager) {
+		forEachComponent(except<TransformMatrixComponent, PrefabInstanceComponent>, [&]<typename T>(utl::tag<T>) {
+			if (!node[T::staticName()].IsDefined()) {
+				return;
+			}
+			// Remove and add again, so the scene sees the new component the same way as a freshly loaded one.
+			if (entity.has<T>()) {
+				entity.remove<T>();
+			}
+			deserializeComponent(node, entity, assetManager, utl::tag<T>{});
+		});
+		YAML::Node const removed = node[removedComponentsKey];
+		if (!removed.IsDefined()) {
+			return;
+		}
+		for (YAML::Node const& nameNode: removed) {
+			auto const name = nameNode.as<std::string>();
+			forEachComponent(except<TransformMatrixComponent, PrefabInstanceComponent>, [&]<typename T>(utl::tag<T>) {
+				if (name == T::staticName() && entity.has<T>()) {
+					entity.remove<T>();
+				}
+			});
+		}
+	}
+	
+	using PrefabCache = utl::hashmap<utl::UUID, Reference<Prefab>>;
+	
+	/// Instantiates the prefab \p node refers to with the identifiers it lists. Returns null if the prefab can't be loaded.
+	/// Entities deleted from the instance and entities the prefab gained since are given identifiers from \p nextFreeIndex on.
+	static EntityID spawnInstance(Scene& scene, YAML::Node const& node, AssetManager& assetManager,
+								  PrefabCache& prefabs, std::size_t& nextFreeIndex)
+	{
+		YAML::Node const instanceNode = node[PrefabInstanceComponent::staticName()];
+		auto const handle = instanceNode["Prefab"].as<AssetHandle>();
+		auto [itr, inserted] = prefabs.insert({ handle.id(), nullptr });
+		if (inserted) {
+			itr->second = as<Prefab>(assetManager.get(handle));
+			if (itr->second) {
+				assetManager.makeAvailable(handle, AssetRepresentation::CPU);
+			}
+		}
+		auto const& prefab = itr->second;
+		if (!prefab || prefab->entities().empty()) {
+			bloomLog(error, "Failed to instantiate prefab \"{}\" of entity {}",
+					 assetManager.getName(handle), node["ID"].as<EntityID::RawType>());
+			return {};
+		}
+		
+		utl::vector<EntityID> ids;
+		for (YAML::Node const& id: instanceNode["Entities"]) {
+			ids.push_back(id.as<EntityID>());
+		}
+		if (ids.size() != prefab->entities().size()) {
+			bloomLog(warning, "Prefab \"{}\" changed since the scene was saved", prefab->name());
+			ids.resize(std::min(ids.size(), prefab->entities().size()));
+			while (ids.size() < prefab->entities().size()) {
+				ids.push_back(entt::entity(nextFreeIndex++));
+			}
+		}
+		// Entities deleted from the instance are spawned with temporary identifiers and deleted again.
+		utl::small_vector<std::size_t> deleted;
+		for (std::size_t i = 0; i < ids.size(); ++i) {
+			if (!ids[i]) {
+				ids[i] = entt::entity(nextFreeIndex++);
+				deleted.push_back(i);
+			}
+		}
+		EntityHandle const root = scene.instantiate(prefab, ids);
+		auto& instance = root.get<PrefabInstanceComponent>();
+		for (std::size_t const i: deleted) {
+			scene.deleteEntity(instance.entities[i]);
+			instance.entities[i] = {};
+		}
+		return root;
+	}
+	
 	BLOOM_API YAML::Node Scene::serialize() const {
+		// Entities of prefab instances are written as their differences to the prefab.
+		utl::hashmap<EntityID, std::pair<PrefabInstanceComponent const*, std::size_t>> instanceEntities;
+		for (auto&& [entity, instance]: _registry.view<PrefabInstanceComponent const>().each()) {
+			std::size_t const count = std::min(instance.entities.size(), instance.prefab->entities().size());
+			for (std::size_t i = 0; i < count; ++i) {
+				if (isValid(instance.entities[i])) {
+					instanceEntities.insert({ instance.entities[i], { &instance, i } });
+				}
+			}
+		}
+		
+		// Nodes that spawn an instance come first, so the streaming loader has created an entity before it reads its overrides.
 		YAML::Node root;
+		utl::vector<YAML::Node> nodes;
+		auto const push = [&](YAML::Node node) {
+			if (node[PrefabInstanceComponent::staticName()].IsDefined()) {
+				root.push_back(node);
+			}
+			else {
+				nodes.push_back(std::move(node));
+			}
+		};
 		each([&](entt::entity entity){
-			root.push_back(serializeEntity(*this, entity));
+			auto const itr = instanceEntities.find(entity);
+			if (itr == instanceEntities.end()) {
+				push(serializeEntity(*this, entity));
+				return;
+			}
+			auto const [instance, index] = itr->second;
+			YAML::Node node = serializeOverrides(*this, *instance, index);
+			// Unmodified entities are recreated from the prefab. The root is always written for its instance data.
+			if (index == 0 || node.size() > 1) {
+				push(std::move(node));
+			}
 		});
+		for (YAML::Node const& node: nodes) {
+			root.push_back(node);
+		}
 		return root;
 	}
 
@@ -171,8 +715,87 @@ namespace bloom {
 			return;
 		}
 		
+		// Identifiers of entities the scene does not know about must not collide with any identifier it lists.
+		std::size_t nextFreeIndex = _registry.size();
 		for (YAML::Node const& node: root) {
-			deserializeEntity(node, *this, assetManager);
+			EntityID const id(node["ID"].as<EntityID::RawType>());
+			nextFreeIndex = std::max<std::size_t>(nextFreeIndex, entt::to_entity(id.value()) + 1);
+			if (YAML::Node const instanceNode = node[PrefabInstanceComponent::staticName()]; instanceNode.IsDefined()) {
+				for (YAML::Node const& entity: instanceNode["Entities"]) {
+					if (EntityID const instanceEntity = entity.as<EntityID>()) {
+						nextFreeIndex = std::max<std::size_t>(nextFreeIndex, entt::to_entity(instanceEntity.value()) + 1);
+					}
+				}
+			}
+		}
+		
+		// Spawn the instances first, the nodes of their entities then only hold overrides.
+		PrefabCache prefabs;
+		for (YAML::Node const& node: root) {
+			if (node[PrefabInstanceComponent::staticName()].IsDefined()) {
+				spawnInstance(*this, node, assetManager, prefabs, nextFreeIndex);
+			}
+		}
+		
+		for (YAML::Node const& node: root) {
+			EntityID const id(node["ID"].as<EntityID::RawType>());
+			if (_registry.valid(id.value())) {
+				deserializeOverrides(node, getHandle(id), assetManager);
+			}
+			else {
+				deserializeEntity(node, *this, assetManager);
+			}
+		}
+	}
+	
+	namespace {
+		/// Thrown by the streaming loader when a node can only be resolved with the whole document.
+		struct StreamConflict {};
+	}
+	
+	BLOOM_API bool Scene::deserialize(std::istream& stream, AssetManager& assetManager) {
+		auto const indexInUse = [&](EntityID id) {
+			std::size_t const index = entt::to_entity(id.value());
+			return index < _registry.size() && entt::to_entity(_registry.data()[index]) == index;
+		};
+		PrefabCache prefabs;
+		try {
+			bool const found = forEachSequenceElement(stream, [&](YAML::Node const& node) {
+				EntityID const id(node["ID"].as<EntityID::RawType>());
+				if (YAML::Node const instanceNode = node[PrefabInstanceComponent::staticName()]; instanceNode.IsDefined()) {
+					// Identifiers are only known up to this node, so the ones of a later entity may already be taken.
+					std::size_t nextFreeIndex = std::max<std::size_t>(_registry.size(), entt::to_entity(id.value()) + 1);
+					for (YAML::Node const& entity: instanceNode["Entities"]) {
+						if (EntityID const instanceEntity = entity.as<EntityID>()) {
+							if (indexInUse(instanceEntity)) {
+								throw StreamConflict{};
+							}
+							nextFreeIndex = std::max<std::size_t>(nextFreeIndex, entt::to_entity(instanceEntity.value()) + 1);
+						}
+					}
+					EntityID const root = spawnInstance(*this, node, assetManager, prefabs, nextFreeIndex);
+					// Entities the prefab gained since the scene was saved took identifiers a later node may list.
+					if (root && getComponent<PrefabInstanceComponent>(root).entities.size() != instanceNode["Entities"].size()) {
+						throw StreamConflict{};
+					}
+				}
+				if (_registry.valid(id.value())) {
+					deserializeOverrides(node, getHandle(id), assetManager);
+				}
+				else if (indexInUse(id)) {
+					throw StreamConflict{};
+				}
+				else {
+					deserializeEntity(node, *this, assetManager);
+				}
+			});
+			if (!found) {
+				bloomLog(info, "Failed to deserialize Scene: Scene is empty.");
+			}
+			return true;
+		}
+		catch (StreamConflict const&) {
+			return false;
 		}
 	}
 	
@@ -184,12 +807,12 @@ namespace bloom {
 			// sanitize child -> parent relationship
 			if (entity.parent) {
 				EntityID const parentID = entity.parent;
-				auto const parentsChildren = scene->gatherChildren(parentID);
+				auto const parentsChildren = scene->children(parentID);
 				if (std::find(parentsChildren.begin(), parentsChildren.end(), entityID) == parentsChildren.end()) {
 					bloomLog(fatal,
 							 "Entity {0} [{1}] thinks Entity {2} [{3}] is its parent but {2} doesn't know about it.",
-							 entityID, scene->getComponent<TagComponent>(entityID).name,
-							 parentID, scene->getComponent<TagComponent>(parentID).name);
+							 entityID, scene->getComponent<TagComponent>(entityID).name.view(),
+							 parentID, scene->getComponent<TagComponent>(parentID).name.view());
 					bloomDebugbreak();
 				}
 			}
@@ -197,14 +820,13 @@ namespace bloom {
 			// sanitize parent -> children relationship
 			if (entity.firstChild) {
 				bloomAssert(!!entity.lastChild);
-				auto const ourChildren = scene->gatherChildren(entityID);
-				for (auto const childID: ourChildren) {
+				for (auto const childID: scene->children(entityID)) {
 					auto const child = scene->getComponent<HierarchyComponent>(childID);
 					if (child.parent != entityID) {
 						bloomLog(fatal,
 								 "Entity {0} [{1}] thinks it's a parent but supposed child {0} [{1}] doesn't know about it.",
-								 entityID, scene->getComponent<TagComponent>(entityID).name,
-								 childID, scene->getComponent<TagComponent>(childID).name);
+								 entityID, scene->getComponent<TagComponent>(entityID).name.view(),
+								 childID, scene->getComponent<TagComponent>(childID).name.view());
 						bloomDebugbreak();
 					}
 				}
@@ -224,11 +846,28 @@ namespace bloom {
 	}
 	
 	void Scene::parent(EntityID c, EntityID p) {
+		linkChild(c, p);
+		
+		auto& t = getComponent<Transform>(c);
+		
+		mtl::float4x4 const parentWorldTransform = calculateTransformRelativeToWorld(p);
+		mtl::float4x4 const childLocalTransform = mtl::inverse(parentWorldTransform) * t.calculate();
+		
+		t = Transform::fromMatrix(childLocalTransform);
+		markTransformDirty(c);
+		
+#if BLOOM_DEBUGLEVEL
+		sanitizeHierachy(this);
+#endif
+	}
+	
+	void Scene::linkChild(EntityID c, EntityID p) {
 		HierarchyComponent& parent = getComponent<HierarchyComponent>(p);
 		HierarchyComponent& newChild = getComponent<HierarchyComponent>(c);
 		bloomExpect(!newChild.parent);
 		
 		newChild.parent = p;
+		invalidateHierarchyOrderSignal(_registry, c.value());
 		
 		if (!parent.firstChild) { // case parent has no children yet
 			bloomAssert(!parent.lastChild);
@@ -252,17 +891,6 @@ namespace bloom {
 			
 			parent.lastChild = c;
 		}
-		
-		auto& t = getComponent<Transform>(c);
-		
-		mtl::float4x4 const parentWorldTransform = calculateTransformRelativeToWorld(p);
-		mtl::float4x4 const childLocalTransform = mtl::inverse(parentWorldTransform) * t.calculate();
-		
-		t = Transform::fromMatrix(childLocalTransform);
-		
-#if BLOOM_DEBUGLEVEL
-		sanitizeHierachy(this);
-#endif
 	}
 	
 	void Scene::unparent(EntityID c) {
@@ -306,10 +934,12 @@ namespace bloom {
 		mtl::float4x4 const childWorldTransform = parentWorldTransform * t.calculate();
 		
 		t = Transform::fromMatrix(childWorldTransform);
+		markTransformDirty(c);
 		
 		child.parent = {};
 		child.prevSibling = {};
 		child.nextSibling = {};
+		invalidateHierarchyOrderSignal(_registry, c.value());
 		
 #if BLOOM_DEBUGLEVEL
 		sanitizeHierachy(this);
@@ -334,33 +964,55 @@ namespace bloom {
 	}
 
 	utl::small_vector<EntityID> Scene::gatherRoots() const {
-		utl::small_vector<EntityID> roots;
-		for (auto [entity, hierachy]: view<HierarchyComponent>().each()) {
-			if (!hierachy.parent) {
-				roots.push_back(EntityID(entity));
-			}
+		utl::small_vector<EntityID> result;
+		for (auto const root: roots()) {
+			result.push_back(root);
 		}
-		return roots;
+		return result;
 	}
 	
 	utl::small_vector<EntityID> Scene::gatherChildren(EntityID parent) const {
-		if (!hasComponent<HierarchyComponent>(parent)) {
-			return {};
+		utl::small_vector<EntityID> result;
+		for (auto const child: children(parent)) {
+			result.push_back(child);
 		}
-		auto const& hierarchy = getComponent<HierarchyComponent>(parent);
-		auto current = hierarchy.firstChild;
-		auto const end = hierarchy.lastChild;
-		
-		utl::small_vector<EntityID> children;
-		while (current) {
-			children.push_back(current);
-			if (current == end) {
-				break;
+		return result;
+	}
+	
+	utl::vector<EntityID> Scene::gatherSubtree(EntityID root) const {
+		utl::vector<EntityID> result;
+		utl::stack<EntityID> stack;
+		stack.push(root);
+		while (stack) {
+			auto const current = stack.pop();
+			result.push_back(current);
+			auto const* const hierarchy = _registry.try_get<HierarchyComponent>(current.value());
+			if (!hierarchy || !hierarchy->firstChild) {
+				continue;
+			}
+			// Push the children back to front so they are visited in order. Sibling lists are circular.
+			for (EntityID c = hierarchy->lastChild;; c = getComponent<HierarchyComponent>(c).prevSibling) {
+				stack.push(c);
+				if (c == hierarchy->firstChild) {
+					break;
+				}
 			}
-			current = getComponent<HierarchyComponent>(current).nextSibling;
 		}
-		
-		return children;
+		return result;
+	}
+	
+	EntityRange<RootIterator> Scene::roots() const {
+		auto const view = _registry.view<HierarchyComponent const>();
+		return { RootIterator(&_registry, view.begin(), view.end()),
+				 RootIterator(&_registry, view.end(), view.end()) };
+	}
+	
+	EntityRange<ChildIterator> Scene::children(EntityID parent) const {
+		if (!hasComponent<HierarchyComponent>(parent)) {
+			return { ChildIterator{}, ChildIterator{} };
+		}
+		auto const& hierarchy = getComponent<HierarchyComponent>(parent);
+		return { ChildIterator(&_registry, hierarchy.firstChild, hierarchy.lastChild), ChildIterator{} };
 	}
 	
 	bool Scene::isLeaf(EntityID entity) const {
@@ -370,15 +1022,430 @@ namespace bloom {
 	}
 	
 	mtl::float4x4 Scene::calculateTransformRelativeToWorld(EntityID entity) const {
-		mtl::float4x4 result = 1;
+		auto const& cache = _registry.ctx().at<WorldTransformCache>();
 		
-		while (entity) {
-			bloomAssert(hasComponent<HierarchyComponent>(entity),
+		// Walk up until we reach an ancestor whose world matrix is current or the root.
+		utl::small_vector<EntityID> uncached;
+		mtl::float4x4 result = 1;
+		for (EntityID current = entity; current; current = getComponent<HierarchyComponent>(current).parent) {
+			bloomAssert(hasComponent<HierarchyComponent>(current),
 						"This API is supposed to be used with hierarchical entities");
-			result *= getComponent<Transform>(entity).calculate();
-			entity = getComponent<HierarchyComponent>(entity).parent;
+			if (cache.isValid(current.value())) {
+				result = getComponent<TransformMatrixComponent>(current).matrix;
+				break;
+			}
+			uncached.push_back(current);
+		}
+		
+		// Then compute the missing world matrices on the way back down, without storing them.
+		for (auto i = uncached.rbegin(); i != uncached.rend(); ++i) {
+			result = result * getComponent<Transform>(*i).calculate();
+		}
+		
+		return result;
+	}
+	
+	/// MARK: Transform hierarchy
+	void Scene::markTransformDirty(EntityID entity) {
+		bloomExpect(hasComponent<Transform>(entity));
+		_registry.patch<Transform>(entity.value());
+	}
+	
+	void Scene::applyTransformHierarchy(TransformHierarchyOptions const& options) {
+		bool const parallel = options.threadPool &&
+			_registry.storage<TransformMatrixComponent>().size() >= options.parallelThreshold;
+		ThreadPool* const threadPool = parallel ? options.threadPool : nullptr;
+		
+		// Gathered once, the incremental update, the spatial index and the cache only visit their subtrees.
+		auto const dirtyRoots = options.incremental ? gatherDirtyRoots() : utl::small_vector<EntityID>{};
+		if (options.packed) {
+			applyTransformHierarchyPacked(options.incremental);
+		}
+		else if (options.incremental) {
+			applyTransformHierarchyIncremental(threadPool, dirtyRoots);
+		}
+		else {
+			applyTransformHierarchyFull(threadPool);
+		}
+		if (options.updateSpatialIndex) {
+			updateSpatialIndex(!options.incremental, dirtyRoots);
+		}
+		validateWorldTransforms(!options.incremental, dirtyRoots);
+		_registry.clear<TransformDirtyTag>();
+	}
+	
+	/// Marks the world matrices just computed as current: all of them if \p full is set, otherwise
+	/// the subtrees of \p dirtyRoots.
+	void Scene::validateWorldTransforms(bool full, std::span<EntityID const> dirtyRoots) {
+		auto& cache = _registry.ctx().at<WorldTransformCache>();
+		if (full) {
+			for (entt::entity const entity: _registry.view<Transform const, TransformMatrixComponent const>()) {
+				cache.setValid(entity, true);
+			}
+			return;
+		}
+		for (EntityID const root: dirtyRoots) {
+			cache.validate(_registry, root.value());
+		}
+	}
+	
+	SpatialIndex const& Scene::spatialIndex() const {
+		return _registry.ctx().at<SpatialIndexState>().index;
+	}
+	
+	void Scene::markBoundsDirty(EntityID entity) {
+		markBoundsDirtySignal(_registry, entity.value());
+	}
+	
+	/// Refreshes the entities whose world matrix may have changed: all of them if \p full is set, otherwise
+	/// the subtrees of \p dirtyRoots. Pending entities are retried until the bounds of their mesh are known.
+	void Scene::updateSpatialIndex(bool full, std::span<EntityID const> dirtyRoots) {
+		auto& state = _registry.ctx().at<SpatialIndexState>();
+		auto const& meshRenderers = _registry.storage<MeshRendererComponent>();
+		auto const& matrices = _registry.storage<TransformMatrixComponent>();
+		
+		utl::vector<entt::entity> stillPending;
+		auto refresh = [&](entt::entity entity) {
+			auto& proxy = state.proxy(entity);
+			bool const hasMesh = meshRenderers.contains(entity) && matrices.contains(entity);
+			std::optional<AABB> const bounds = hasMesh && meshRenderers.get(entity).mesh ?
+				meshRenderers.get(entity).mesh->bounds() : std::nullopt;
+			if (!bounds) {
+				if (proxy != SpatialIndex::nullProxy) {
+					state.index.remove(proxy);
+					proxy = SpatialIndex::nullProxy;
+				}
+				if (hasMesh) {
+					stillPending.push_back(entity);
+				}
+				return;
+			}
+			AABB const worldBounds = transform(*bounds, matrices.get(entity).matrix);
+			if (proxy == SpatialIndex::nullProxy) {
+				proxy = state.index.insert(worldBounds, entity);
+			}
+			else {
+				state.index.update(proxy, worldBounds);
+			}
+		};
+		
+		if (full) {
+			for (entt::entity const entity: _registry.view<MeshRendererComponent>()) {
+				refresh(entity);
+			}
+		}
+		else if (!meshRenderers.empty()) {
+			// The subtrees are disjoint, so every entity is refreshed at most once.
+			utl::stack<EntityID> stack;
+			for (EntityID const root: dirtyRoots) {
+				stack.push(root);
+			}
+			while (stack) {
+				EntityID const current = stack.pop();
+				if (meshRenderers.contains(current.value())) {
+					refresh(current.value());
+				}
+				if (!hasComponent<HierarchyComponent>(current)) {
+					continue;
+				}
+				for (auto const child: children(current)) {
+					stack.push(child);
+				}
+			}
+		}
+		
+		for (entt::entity const entity: std::exchange(state.pending, {})) {
+			if (_registry.valid(entity)) {
+				refresh(entity);
+			}
+		}
+		std::sort(stillPending.begin(), stillPending.end());
+		stillPending.erase(std::unique(stillPending.begin(), stillPending.end()), stillPending.end());
+		state.pending = std::move(stillPending);
+	}
+	
+	/// Runs \p function over [0, \p count) on \p threadPool, or as a single chunk on the calling thread if it is null.
+	static void forEachChunk(ThreadPool* threadPool, std::size_t count, std::size_t grainSize,
+							 utl::function<void(std::size_t, std::size_t)> const& function)
+	{
+		if (threadPool) {
+			threadPool->parallelFor(count, grainSize, function);
+		}
+		else if (count > 0) {
+			function(0, count);
+		}
+	}
+	
+	/// Subtrees vary in size, so hand them out in several chunks per thread to balance the load.
+	static std::size_t subtreeGrainSize(ThreadPool* threadPool, std::size_t subtreeCount) {
+		std::size_t const threadCount = threadPool ? threadPool->workerCount() + 1 : 1;
+		return std::max<std::size_t>(1, subtreeCount / (4 * threadCount));
+	}
+	
+	/// Number of transforms handed to the batch kernels at once. Siblings are batched to share their parent's matrix.
+	static constexpr std::size_t transformBatchSize = 16;
+	
+	void Scene::applyTransformHierarchyFull(ThreadPool* threadPool) {
+		// Work on the pools directly, registry lookups may create pools and are not safe to perform concurrently.
+		auto const& transforms = std::as_const(_registry).storage<Transform>();
+		auto& transformMatrices = _registry.storage<TransformMatrixComponent>();
+		
+		forEachChunk(threadPool, transformMatrices.size(), 1024, [&](std::size_t begin, std::size_t end) {
+			std::array<entt::entity, transformBatchSize> batchEntities;
+			std::array<Transform, transformBatchSize> batchTransforms;
+			std::array<mtl::float4x4, transformBatchSize> batchMatrices;
+			std::size_t batchCount = 0;
+			auto flush = [&]{
+				calculateTransforms(batchTransforms.data(), batchMatrices.data(), batchCount);
+				for (std::size_t i = 0; i < batchCount; ++i) {
+					transformMatrices.get(batchEntities[i]).matrix = batchMatrices[i];
+				}
+				batchCount = 0;
+			};
+			
+			for (std::size_t i = begin; i < end; ++i) {
+				entt::entity const entity = transformMatrices.data()[i];
+				if (!transforms.contains(entity)) {
+					continue;
+				}
+				batchEntities[batchCount] = entity;
+				batchTransforms[batchCount] = transforms.get(entity);
+				if (++batchCount == transformBatchSize) {
+					flush();
+				}
+			}
+			flush();
+		});
+		
+		auto propagate = [&](utl::stack<EntityID>& stack) {
+			std::array<EntityID, transformBatchSize> batchEntities;
+			std::array<mtl::float4x4, transformBatchSize> batchMatrices;
+			
+			while (stack) {
+				auto const current = stack.pop();
+				mtl::float4x4 const currentMatrix = transformMatrices.get(current.value()).matrix;
+				
+				std::size_t batchCount = 0;
+				auto flush = [&]{
+					multiplyMatrices(currentMatrix, batchMatrices.data(), batchMatrices.data(), batchCount);
+					for (std::size_t i = 0; i < batchCount; ++i) {
+						transformMatrices.get(batchEntities[i].value()).matrix = batchMatrices[i];
+					}
+					batchCount = 0;
+				};
+				
+				for (auto const c: children(current)) {
+					batchEntities[batchCount] = c;
+					batchMatrices[batchCount] = transformMatrices.get(c.value()).matrix;
+					stack.push(c);
+					if (++batchCount == transformBatchSize) {
+						flush();
+					}
+				}
+				flush();
+			}
+		};
+		
+		if (!threadPool) {
+			utl::stack<EntityID> stack;
+			for (auto const root: roots()) {
+				stack.push(root);
+			}
+			propagate(stack);
+			return;
+		}
+		
+		// Subtrees of different roots are disjoint, so they can be propagated concurrently.
+		auto const rootList = gatherRoots();
+		forEachChunk(threadPool, rootList.size(), subtreeGrainSize(threadPool, rootList.size()),
+					 [&](std::size_t begin, std::size_t end) {
+			utl::stack<EntityID> stack;
+			for (std::size_t i = begin; i < end; ++i) {
+				stack.push(rootList[i]);
+			}
+			propagate(stack);
+		});
+	}
+	
+	void Scene::applyTransformHierarchyIncremental(ThreadPool* threadPool, std::span<EntityID const> topmostDirty) {
+		auto const& transforms = std::as_const(_registry).storage<Transform>();
+		auto const& hierarchies = std::as_const(_registry).storage<HierarchyComponent>();
+		auto& transformMatrices = _registry.storage<TransformMatrixComponent>();
+		
+		// Only the topmost dirty entity of every modified subtree needs to be visited,
+		// its descendants are recomputed along the way. These subtrees are disjoint.
+		utl::small_vector<EntityID> dirtyRoots;
+		for (EntityID const entity: topmostDirty) {
+			if (_registry.all_of<Transform, TransformMatrixComponent>(entity.value())) {
+				dirtyRoots.push_back(entity);
+			}
+		}
+		
+		forEachChunk(threadPool, dirtyRoots.size(), subtreeGrainSize(threadPool, dirtyRoots.size()),
+					 [&](std::size_t begin, std::size_t end) {
+			utl::stack<EntityID> stack;
+			for (std::size_t i = begin; i < end; ++i) {
+				auto const root = dirtyRoots[i];
+				auto& transformMatrix = transformMatrices.get(root.value());
+				transformMatrix.matrix = transforms.get(root.value()).calculate();
+				// The parent is clean, otherwise we would not be the topmost dirty entity.
+				if (hierarchies.contains(root.value())) {
+					if (auto const parent = hierarchies.get(root.value()).parent) {
+						transformMatrix.matrix = transformMatrices.get(parent.value()).matrix * transformMatrix.matrix;
+					}
+				}
+				stack.push(root);
+			}
+			
+			std::array<EntityID, transformBatchSize> batchEntities;
+			std::array<Transform, transformBatchSize> batchTransforms;
+			std::array<mtl::float4x4, transformBatchSize> batchMatrices;
+			
+			// Every entity on the stack already holds its final world matrix.
+			while (stack) {
+				auto const current = stack.pop();
+				mtl::float4x4 const currentMatrix = transformMatrices.get(current.value()).matrix;
+				
+				std::size_t batchCount = 0;
+				auto flush = [&]{
+					calculateTransforms(batchTransforms.data(), batchMatrices.data(), batchCount);
+					multiplyMatrices(currentMatrix, batchMatrices.data(), batchMatrices.data(), batchCount);
+					for (std::size_t i = 0; i < batchCount; ++i) {
+						transformMatrices.get(batchEntities[i].value()).matrix = batchMatrices[i];
+					}
+					batchCount = 0;
+				};
+				
+				for (auto const c: children(current)) {
+					batchEntities[batchCount] = c;
+					batchTransforms[batchCount] = transforms.get(c.value());
+					stack.push(c);
+					if (++batchCount == transformBatchSize) {
+						flush();
+					}
+				}
+				flush();
+			}
+		});
+	}
+	
+	void Scene::applyTransformHierarchyPacked(bool incremental) {
+		sortHierarchy();
+		
+		// Parents come before their children, so a parent's world matrix is always final when we reach its children.
+		for (auto&& [entity, hierarchy]: view<HierarchyComponent const>().each()) {
+			auto* const transform = _registry.try_get<Transform>(entity);
+			auto* const transformMatrix = _registry.try_get<TransformMatrixComponent>(entity);
+			if (!transform || !transformMatrix) {
+				continue;
+			}
+			if (incremental) {
+				bool const parentDirty = hierarchy.parent && _registry.all_of<TransformDirtyTag>(hierarchy.parent.value());
+				if (parentDirty) {
+					_registry.emplace_or_replace<TransformDirtyTag>(entity);
+				}
+				else if (!_registry.all_of<TransformDirtyTag>(entity)) {
+					continue;
+				}
+			}
+			transformMatrix->matrix = transform->calculate();
+			if (!hierarchy.parent) {
+				continue;
+			}
+			if (auto const* parentTransform = _registry.try_get<TransformMatrixComponent>(hierarchy.parent.value())) {
+				transformMatrix->matrix = parentTransform->matrix * transformMatrix->matrix;
+			}
 		}
 		
+		// Entities outside of the hierarchy are their own roots.
+		auto standalone = _registry.view<Transform const, TransformMatrixComponent>(entt::exclude<HierarchyComponent>);
+		for (auto&& [entity, transform, transformMatrix]: standalone.each()) {
+			if (!incremental || _registry.all_of<TransformDirtyTag>(entity)) {
+				transformMatrix.matrix = transform.calculate();
+			}
+		}
+	}
+	
+	/// Cached world matrices need not be invalidated, entities whose parent changes are invalidated by their signals.
+	void Scene::invalidateHierarchyOrder() {
+		_registry.ctx().at<HierarchyOrderState>().sorted = false;
+	}
+	
+	void Scene::sortHierarchy() {
+		auto& state = _registry.ctx().at<HierarchyOrderState>();
+		if (state.sorted) {
+			return;
+		}
+		
+		// Assign pre-order ranks, this keeps parents before children and subtrees contiguous.
+		// Entities not reachable from a root are moved to the back.
+		utl::vector<std::uint32_t> rank(_registry.size(), std::numeric_limits<std::uint32_t>::max());
+		std::uint32_t nextRank = 0;
+		utl::stack<EntityID> stack;
+		for (auto const root: roots()) {
+			stack.push(root);
+			while (stack) {
+				auto const current = stack.pop();
+				rank[entt::to_entity(current.value())] = nextRank++;
+				for (auto const c: children(current)) {
+					stack.push(c);
+				}
+			}
+		}
+		
+		_registry.sort<HierarchyComponent>([&](entt::entity lhs, entt::entity rhs) {
+			return rank[entt::to_entity(lhs)] < rank[entt::to_entity(rhs)];
+		});
+		_registry.sort<Transform, HierarchyComponent>();
+		_registry.sort<TransformMatrixComponent, HierarchyComponent>();
+		
+		state.sorted = true;
+	}
+	
+	utl::small_vector<EntityID> Scene::gatherDirtyRoots() {
+		auto& state = _registry.ctx().at<DirtyRootState>();
+		if (++state.pass == 0) {
+			std::fill(state.visits.begin(), state.visits.end(), DirtyRootState::Visit{});
+			state.pass = 1;
+		}
+		if (state.visits.size() < _registry.size()) {
+			state.visits.resize(_registry.size());
+		}
+		auto const& hierarchies = std::as_const(_registry).storage<HierarchyComponent>();
+		auto const& dirty = std::as_const(_registry).storage<TransformDirtyTag>();
+		
+		// Every clean ancestor is resolved once and stamped with the result, so later walks stop there.
+		// After a load or a copy every entity is dirty, this keeps the pass linear instead of O(n * depth).
+		utl::small_vector<EntityID> result;
+		utl::small_vector<entt::entity> path;
+		for (entt::entity const entity: dirty) {
+			bool dirtyAncestor = false;
+			entt::entity current = entity;
+			path.clear();
+			while (hierarchies.contains(current)) {
+				EntityID const parent = hierarchies.get(current).parent;
+				if (!parent) {
+					break;
+				}
+				if (dirty.contains(parent.value())) {
+					dirtyAncestor = true;
+					break;
+				}
+				auto const& visit = state.visits[entt::to_entity(parent.value())];
+				if (visit.pass == state.pass) {
+					dirtyAncestor = visit.dirtyAncestor;
+					break;
+				}
+				path.push_back(parent.value());
+				current = parent.value();
+			}
+			for (entt::entity const visited: path) {
+				state.visits[entt::to_entity(visited)] = { state.pass, dirtyAncestor };
+			}
+			if (!dirtyAncestor) {
+				result.push_back(entity);
+			}
+		}
 		return result;
 	}
 	
@@ -7,29 +7,90 @@
 
 #include "Components/AllComponents.hpp"
 #include "Entity.hpp"
+#include "HierarchyRange.hpp"
+#include "SpatialIndex.hpp"
 
 #include <entt/entt.hpp>
 #include <mtl/mtl.hpp>
+#include <iosfwd>
+#include <span>
 #include <string>
+#include <utl/vector.hpp>
 #include <yaml-cpp/yaml.h>
 
 namespace bloom {
 	
+	class ThreadPool;
+	
+	struct BLOOM_API TransformHierarchyOptions {
+		/// Only recompute the subtrees of entities whose transform changed since the last update.
+		bool incremental = true;
+		
+		/// Keep the hierarchy and transform pools sorted parent-before-child and update them in a single linear pass.
+		/// The pools are re-sorted lazily whenever the topology of the hierarchy changed.
+		bool packed = false;
+		
+		/// Computes local matrices and propagates independent subtrees on this pool. Runs serially if null.
+		/// The packed update always runs serially since it relies on its linear order.
+		ThreadPool* threadPool = nullptr;
+		
+		/// Scenes with fewer transforms than this are updated serially, even if a thread pool is provided.
+		std::size_t parallelThreshold = 4096;
+		
+		/// Moves the world bounds of mesh entities whose transform changed in the spatial index.
+		bool updateSpatialIndex = true;
+	};
+	
 	class BLOOM_API Scene: public Asset {
 	public:
-		using Asset::Asset;
+		explicit Scene(AssetHandle handle, std::string name);
+		
 		EntityHandle createEntity(std::string_view name);
 		EntityHandle createEmptyEntity();
 		EntityHandle createEmptyEntity(EntityID hint);
 		
+		/// Creates \p count entities with the same components as \p createEntity(name).
+		/// Component pools are reserved up front and filled with range insertions.
+		utl::vector<EntityID> createEntities(std::size_t count, std::string_view name);
+		
+		/// Destroys all entities in \p entities. Like \p deleteEntity(), this does not fix up the hierarchy,
+		/// so either pass complete subtrees or unparent the entities first.
+		void destroyEntities(std::span<EntityID const> entities);
+		
+		bool isValid(EntityID id) const { return _registry.valid(id.value()); }
 		
 		EntityHandle getHandle(EntityID id) { return EntityHandle(id, this); }
 		ConstEntityHandle getHandle(EntityID id) const { return ConstEntityHandle(id, this); }
 		
 		EntityHandle cloneEntity(EntityID);
 		
+		/// Clones \p root and all of its descendants. Components are copied one pool at a time and the clone
+		/// is attached to the parent of \p root. Local transforms are kept as they are.
+		EntityHandle cloneSubtree(EntityID root);
+		
+		/// Copies \p entities of \p source into this scene, one component pool at a time. Pass complete subtrees,
+		/// hierarchy links between the copied entities are pointed at the copies and links to any other entity are cleared.
+		/// @param ids	Identifiers of the copies. Fresh identifiers are created if empty.
+		/// @returns	The copies, in the order of \p entities.
+		utl::vector<EntityID> copyEntities(Scene const& source, std::span<EntityID const> entities,
+										   std::span<EntityID const> ids = {});
+		
+		/// MARK: Prefabs
+		/// Spawns a copy of the template of \p prefab as a new root and marks it with a \p PrefabInstanceComponent.
+		/// @param ids	Identifiers of the instance entities in the order of \p Prefab::entities(), used when loading.
+		EntityHandle instantiate(Reference<Prefab> const& prefab, std::span<EntityID const> ids = {});
+		
 		void deleteEntity(EntityID);
 		
+		/// MARK: Names
+		/// Renames \p entity. Renaming through this function keeps the name index up to date.
+		void setName(EntityID entity, std::string_view name);
+		
+		/// Lookup through a hash index on the interned names.
+		utl::small_vector<EntityID> findEntities(std::string_view name) const;
+		/// Returns the first entity named \p name or a null ID.
+		EntityID findEntity(std::string_view name) const;
+		
 		template <ComponentType T>
 		bool hasComponent(EntityID entity) const {
 			return _registry.any_of<T>(entity.value());
@@ -75,11 +136,24 @@ namespace bloom {
 			_registry.each(UTL_FORWARD(f));
 		}
 		
-		Scene copy();
+		/// Copies every component pool wholesale instead of visiting entities one by one.
+		/// Entity identifiers, including the list of released identifiers, are preserved exactly,
+		/// so moving a copy back into the scene keeps entity handles into the scene valid.
+		Scene copy() const;
 		
 		/// MARK: Serialize
 		YAML::Node serialize() const;
 		void deserialize(YAML::Node const&, AssetManager&);
+		/// Reads the text format entity by entity, without holding the whole document in memory.
+		/// Returns false if a node can only be resolved with the whole document, as in files written before instances were stored first.
+		/// The scene then has to be reset and read with the overload above.
+		bool deserialize(std::istream&, AssetManager&);
+		
+		/// Compact encoding with one block per component type, used for scenes stored as \p FileFormat::binary.
+		/// Prefab instances are stored expanded, only the text format records them as overrides of their prefab.
+		void serializeBinary(std::ostream&) const;
+		/// Expects an empty scene, entity identifiers are restored exactly. Throws if \p stream is not a binary scene.
+		void deserializeBinary(std::istream&, AssetManager&);
 		
 		/// MARK: Hierarchy functionality. Maybe extract this later
 		void parent(EntityID child, EntityID parent);
@@ -89,11 +163,51 @@ namespace bloom {
 		bool descendsFrom(EntityID descendend, EntityID ancestor) const;
 		utl::small_vector<EntityID> gatherRoots() const;
 		utl::small_vector<EntityID> gatherChildren(EntityID parent) const;
+		/// \p root followed by all of its descendants in depth first order.
+		utl::vector<EntityID> gatherSubtree(EntityID root) const;
+		
+		/// Lazy, allocation free alternatives to \p gatherRoots() and \p gatherChildren().
+		/// The hierarchy must not be modified while iterating.
+		EntityRange<RootIterator> roots() const;
+		EntityRange<ChildIterator> children(EntityID parent) const;
 		
 		bool isLeaf(EntityID) const;
 		
+		/// Returns the \p TransformMatrixComponent computed by \p applyTransformHierarchy() in O(1) while neither
+		/// the entity nor one of its ancestors has changed since. Otherwise the stale part of the parent chain is
+		/// computed on the fly. Transforms modified through a reference must be reported with \p markTransformDirty().
+		/// Only reads the scene, so like any other read it must not overlap with a step modifying it.
 		mtl::float4x4 calculateTransformRelativeToWorld(EntityID) const;
 		
+		/// MARK: Transform hierarchy
+		/// Notifies the scene that the \p Transform of \p entity was modified through a reference.
+		/// Modifications through \p Scene APIs mark the transform automatically.
+		void markTransformDirty(EntityID entity);
+		
+		/// Writes the world space transform of every entity into its \p TransformMatrixComponent.
+		void applyTransformHierarchy(TransformHierarchyOptions const& = {});
+		
+		/// MARK: Spatial queries
+		/// World space bounds of every entity with a loaded mesh, as of the last \p applyTransformHierarchy().
+		SpatialIndex const& spatialIndex() const;
+		
+		/// Notifies the scene that the mesh of \p entity was replaced through a reference.
+		void markBoundsDirty(EntityID entity);
+		
+	private:
+		void connectSignals();
+		/// Inserts \p child into the child list of \p parent without touching any transform.
+		void linkChild(EntityID child, EntityID parent);
+		void applyTransformHierarchyFull(ThreadPool*);
+		void applyTransformHierarchyIncremental(ThreadPool*, std::span<EntityID const> dirtyRoots);
+		void applyTransformHierarchyPacked(bool incremental);
+		void updateSpatialIndex(bool full, std::span<EntityID const> dirtyRoots);
+		void validateWorldTransforms(bool full, std::span<EntityID const> dirtyRoots);
+		/// Dirty entities without a dirty ancestor. Their subtrees are disjoint and cover every modified transform.
+		utl::small_vector<EntityID> gatherDirtyRoots();
+		void invalidateHierarchyOrder();
+		void sortHierarchy();
+		
 	private:
 		entt::registry _registry;
 	};
@@ -0,0 +1,327 @@
+#include "Scene.hpp"
+
+#include "Prefab.hpp"
+
+#include "Bloom/Asset/AssetManager.hpp"
+
+#include <utl/format.hpp>
+#include <utl/hashmap.hpp>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace bloom {
+	
+	/// MARK: Format
+	/// Header, entity list, then one block per component type: name, byte size, count, entities and components.
+	/// Blocks are skipped by name if the component is unknown, so components can be added without a new version.
+	/// Values are written in the native layout, the text format is the one to exchange between machines.
+	static constexpr std::uint32_t sceneMagic = 0x4E435342; // "BSCN"
+	static constexpr std::uint32_t sceneVersion = 1;
+	
+	template <typename T>
+	static void writeValue(std::ostream& stream, T const& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		stream.write(reinterpret_cast<char const*>(&value), sizeof value);
+	}
+	
+	template <typename T>
+	static void writeArray(std::ostream& stream, T const* data, std::size_t count) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		stream.write(reinterpret_cast<char const*>(data), count * sizeof(T));
+	}
+	
+	static void writeString(std::ostream& stream, std::string_view string) {
+		writeValue(stream, static_cast<std::uint32_t>(string.size()));
+		stream.write(string.data(), string.size());
+	}
+	
+	static void checkStream(std::istream& stream) {
+		if (!stream) {
+			throw std::runtime_error("Scene stream is truncated");
+		}
+	}
+	
+	template <typename T>
+	static T readValue(std::istream& stream) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		T value;
+		stream.read(reinterpret_cast<char*>(&value), sizeof value);
+		checkStream(stream);
+		return value;
+	}
+	
+	template <typename T>
+	static void readArray(std::istream& stream, T* data, std::size_t count) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		stream.read(reinterpret_cast<char*>(data), count * sizeof(T));
+		checkStream(stream);
+	}
+	
+	static std::string readString(std::istream& stream) {
+		auto const size = readValue<std::uint32_t>(stream);
+		if (size > (1u << 16)) {
+			throw std::runtime_error("Scene stream is corrupted");
+		}
+		std::string result(size, '\0');
+		stream.read(result.data(), result.size());
+		checkStream(stream);
+		return result;
+	}
+	
+	/// MARK: Components
+	/// Assets are looked up and requested once per scene, not once per component.
+	namespace {
+		struct ReadContext {
+			AssetManager& assetManager;
+			utl::hashmap<utl::UUID, Reference<Asset>> assets;
+			
+			template <typename T>
+			Reference<T> get(AssetHandle handle, AssetRepresentation rep) {
+				if (!handle) {
+					return nullptr;
+				}
+				auto [itr, inserted] = assets.insert({ handle.id(), nullptr });
+				if (inserted) {
+					itr->second = assetManager.get(handle);
+					if (!itr->second) {
+						return nullptr;
+					}
+					if constexpr (std::is_same_v<T, Prefab>) {
+						// Serializing the instance again compares it to the prefab.
+						assetManager.makeAvailable(handle, rep);
+					}
+					else {
+						assetManager.makeAvailableAsync(handle, rep);
+					}
+				}
+				return as<T>(itr->second);
+			}
+		};
+	}
+	
+	static void writeComponent(std::ostream& stream, Scene const&, TagComponent const& tag) {
+		writeString(stream, std::string_view(tag.name));
+	}
+	
+	static TagComponent readComponent(std::istream& stream, ReadContext&, utl::tag<TagComponent>) {
+		return { readString(stream) };
+	}
+	
+	static void writeComponent(std::ostream& stream, Scene const&, MeshRendererComponent const& meshRenderer) {
+		writeValue(stream, meshRenderer.materialInstance ? meshRenderer.materialInstance->handle() : AssetHandle{});
+		writeValue(stream, meshRenderer.mesh ? meshRenderer.mesh->handle() : AssetHandle{});
+	}
+	
+	static MeshRendererComponent readComponent(std::istream& stream, ReadContext& context, utl::tag<MeshRendererComponent>) {
+		MeshRendererComponent result;
+		result.materialInstance = context.get<MaterialInstance>(readValue<AssetHandle>(stream), AssetRepresentation::GPU);
+		result.mesh = context.get<StaticMesh>(readValue<AssetHandle>(stream), AssetRepresentation::GPU);
+		return result;
+	}
+	
+	/// Only the class is stored, the object is instantiated by the script system.
+	static void writeComponent(std::ostream& stream, Scene const&, ScriptComponent const& script) {
+		writeString(stream, script.className);
+	}
+	
+	static ScriptComponent readComponent(std::istream& stream, ReadContext&, utl::tag<ScriptComponent>) {
+		ScriptComponent result;
+		result.className = readString(stream);
+		return result;
+	}
+	
+	/// Entities of the instance that were deleted from \p scene are written as null.
+	static void writeComponent(std::ostream& stream, Scene const& scene, PrefabInstanceComponent const& instance) {
+		writeValue(stream, instance.prefab ? instance.prefab->handle() : AssetHandle{});
+		writeValue(stream, static_cast<std::uint32_t>(instance.entities.size()));
+		for (EntityID const entity: instance.entities) {
+			writeValue(stream, scene.isValid(entity) ? entity : EntityID{});
+		}
+	}
+	
+	static PrefabInstanceComponent readComponent(std::istream& stream, ReadContext& context, utl::tag<PrefabInstanceComponent>) {
+		PrefabInstanceComponent result;
+		result.prefab = context.get<Prefab>(readValue<AssetHandle>(stream), AssetRepresentation::CPU);
+		auto const count = readValue<std::uint32_t>(stream);
+		if (count > (1u << 24)) {
+			throw std::runtime_error("Scene stream is corrupted");
+		}
+		result.entities.resize(count);
+		readArray(stream, result.entities.data(), result.entities.size());
+		return result;
+	}
+	
+	/// MARK: Columns
+	/// Components with a \p writeComponent() overload are written one by one, everything else as one array.
+	/// Raw arrays only hold plain values, components referring to memory need an overload.
+	template <typename T>
+	concept HasComponentCodec = requires(std::ostream& stream, Scene const& scene, T const& component) {
+		writeComponent(stream, scene, component);
+	};
+	
+	template <typename T>
+	static void writeColumn(std::ostream& stream, Scene const& scene, entt::storage<T> const& pool) {
+		writeValue(stream, static_cast<std::uint64_t>(pool.size()));
+		// data() lists the entities in packed order, the reverse iterators visit the components in the same order.
+		writeArray(stream, pool.data(), pool.size());
+		if constexpr (HasComponentCodec<T>) {
+			for (auto itr = pool.crbegin(); itr != pool.crend(); ++itr) {
+				writeComponent(stream, scene, *itr);
+			}
+		}
+		else {
+			utl::vector<T> const components(pool.crbegin(), pool.crend());
+			writeArray(stream, components.data(), components.size());
+		}
+	}
+	
+	/// Raw components must have the size they were written with, e.g. not from a build with a different layout.
+	/// The size of other blocks is only checked on streams that report their position.
+	template <typename T>
+	static void readColumn(std::istream& stream, std::uint64_t blockSize, ReadContext& context, entt::registry& registry) {
+		auto const begin = stream.tellg();
+		auto const count = readValue<std::uint64_t>(stream);
+		if (count > registry.alive()) {
+			throw std::runtime_error(utl::format("Scene stream lists {} \"{}\" components for {} entities",
+												 count, T::staticName(), registry.alive()));
+		}
+		if constexpr (!HasComponentCodec<T>) {
+			if (blockSize != sizeof(std::uint64_t) + count * (sizeof(entt::entity) + sizeof(T))) {
+				throw std::runtime_error(utl::format("Scene stream stores \"{}\" components of a different size", T::staticName()));
+			}
+		}
+		utl::vector<entt::entity> entities(count);
+		readArray(stream, entities.data(), entities.size());
+		auto& pool = registry.storage<T>();
+		utl::vector<std::uint8_t> listed(registry.size());
+		for (auto const entity: entities) {
+			if (!registry.valid(entity)) {
+				throw std::runtime_error(utl::format("Scene stream lists a \"{}\" component for an unknown entity", T::staticName()));
+			}
+			auto& seen = listed[entt::to_entity(entity)];
+			if (seen || pool.contains(entity)) {
+				throw std::runtime_error(utl::format("Scene stream lists two \"{}\" components for one entity", T::staticName()));
+			}
+			seen = true;
+		}
+		utl::vector<T> components;
+		if constexpr (HasComponentCodec<T>) {
+			components.reserve(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				components.push_back(readComponent(stream, context, utl::tag<T>{}));
+			}
+		}
+		else {
+			components.resize(count);
+			readArray(stream, components.data(), components.size());
+		}
+		if (begin != std::istream::pos_type(-1) && std::uint64_t(stream.tellg() - begin) != blockSize) {
+			throw std::runtime_error(utl::format("Scene stream stores a \"{}\" block of the wrong size", T::staticName()));
+		}
+		pool.reserve(pool.size() + count);
+		pool.insert(entities.begin(), entities.end(), components.begin());
+	}
+	
+	/// MARK: Scene
+	/// Every slot of \p entities is either alive, holding its own index, or linked into the list starting at \p released.
+	/// A corrupted list would make the registry loop or hand out identifiers that are alive. Returns the length of the list.
+	static std::size_t validateEntities(std::span<entt::entity const> entities, entt::entity released) {
+		std::size_t releasedCount = 0;
+		for (auto curr = released; curr != entt::null; ++releasedCount) {
+			std::size_t const index = entt::to_entity(curr);
+			if (releasedCount == entities.size() || index >= entities.size() || entt::to_entity(entities[index]) == index) {
+				throw std::runtime_error("Scene stream is corrupted");
+			}
+			curr = entities[index];
+		}
+		std::size_t aliveCount = 0;
+		for (std::size_t i = 0; i < entities.size(); ++i) {
+			aliveCount += entt::to_entity(entities[i]) == i;
+		}
+		if (aliveCount + releasedCount != entities.size()) {
+			throw std::runtime_error("Scene stream is corrupted");
+		}
+		return releasedCount;
+	}
+	
+	void Scene::serializeBinary(std::ostream& stream) const {
+		writeValue(stream, sceneMagic);
+		writeValue(stream, sceneVersion);
+		
+		// The list of released identifiers is stored too, so the scene hands out the same identifiers after loading.
+		writeValue(stream, static_cast<std::uint64_t>(_registry.size()));
+		writeValue(stream, _registry.released());
+		writeArray(stream, _registry.data(), _registry.size());
+		
+		std::uint32_t blockCount = 0;
+		forEachComponent(except<TransformMatrixComponent>, [&]<typename T>(utl::tag<T>) {
+			blockCount += !_registry.storage<T>().empty();
+		});
+		writeValue(stream, blockCount);
+		forEachComponent(except<TransformMatrixComponent>, [&]<typename T>(utl::tag<T>) {
+			auto const& pool = _registry.storage<T>();
+			if (pool.empty()) {
+				return;
+			}
+			std::ostringstream block;
+			writeColumn<T>(block, *this, pool);
+			auto const data = std::move(block).str();
+			writeString(stream, T::staticName());
+			writeValue(stream, static_cast<std::uint64_t>(data.size()));
+			stream.write(data.data(), data.size());
+		});
+		if (!stream) {
+			throw std::runtime_error("Failed to write scene");
+		}
+	}
+	
+	void Scene::deserializeBinary(std::istream& stream, AssetManager& assetManager) {
+		bloomExpect(empty(), "Binary scenes restore their entity identifiers and must be loaded into an empty scene");
+		if (readValue<std::uint32_t>(stream) != sceneMagic) {
+			throw std::runtime_error("Not a binary scene");
+		}
+		if (auto const version = readValue<std::uint32_t>(stream); version != sceneVersion) {
+			throw std::runtime_error(utl::format("Unsupported binary scene version {}", version));
+		}
+		
+		auto const size = readValue<std::uint64_t>(stream);
+		auto const released = readValue<entt::entity>(stream);
+		if (size > std::size_t(entt::to_entity(entt::entity(entt::null))) + 1) {
+			throw std::runtime_error("Scene stream is corrupted");
+		}
+		utl::vector<entt::entity> entities(size);
+		readArray(stream, entities.data(), entities.size());
+		std::size_t const releasedCount = validateEntities(entities, released);
+		_registry.assign(entities.begin(), entities.end(), released);
+		
+		// Matrices are not stored, every entity gets one like in the text format.
+		utl::vector<entt::entity> alive;
+		alive.reserve(size - releasedCount);
+		_registry.each([&](entt::entity entity) { alive.push_back(entity); });
+		_registry.insert<TransformMatrixComponent>(alive.begin(), alive.end());
+		
+		ReadContext context{ assetManager };
+		auto const blockCount = readValue<std::uint32_t>(stream);
+		for (std::uint32_t i = 0; i < blockCount; ++i) {
+			auto const name = readString(stream);
+			auto const blockSize = readValue<std::uint64_t>(stream);
+			bool known = false;
+			forEachComponent(except<TransformMatrixComponent>, [&]<typename T>(utl::tag<T>) {
+				if (!known && name == T::staticName()) {
+					known = true;
+					readColumn<T>(stream, blockSize, context, _registry);
+				}
+			});
+			if (!known) {
+				bloomLog(warning, "Skipping unknown component \"{}\" in binary scene", name);
+				stream.ignore(blockSize);
+				checkStream(stream);
+			}
+		}
+	}
+	
+}
@@ -0,0 +1,256 @@
+#include "SpatialIndex.hpp"
+
+#include "Bloom/Core/Debug.hpp"
+
+#include <algorithm>
+
+namespace bloom {
+	
+	SpatialIndex::ProxyID SpatialIndex::insert(AABB const& bounds, EntityID entity) {
+		std::int32_t const leaf = allocateNode();
+		Node& node = mNodes[leaf];
+		node.bounds = bounds.expanded(mMargin);
+		node.tightBounds = bounds;
+		node.entity = entity;
+		node.height = 0;
+		insertLeaf(leaf);
+		++mLeafCount;
+		return leaf;
+	}
+	
+	void SpatialIndex::remove(ProxyID proxy) {
+		bloomExpect(mNodes[proxy].isLeaf());
+		removeLeaf(proxy);
+		freeNode(proxy);
+		--mLeafCount;
+	}
+	
+	bool SpatialIndex::update(ProxyID proxy, AABB const& bounds) {
+		Node& node = mNodes[proxy];
+		bloomExpect(node.isLeaf());
+		node.tightBounds = bounds;
+		// Keep the fat box unless the object left it or shrank a lot since it was inserted.
+		if (node.bounds.contains(bounds) && bounds.expanded(4 * mMargin).contains(node.bounds)) {
+			return false;
+		}
+		removeLeaf(proxy);
+		mNodes[proxy].bounds = bounds.expanded(mMargin);
+		insertLeaf(proxy);
+		return true;
+	}
+	
+	void SpatialIndex::clear() {
+		mNodes.clear();
+		mRoot = nullNode;
+		mFreeList = nullNode;
+		mLeafCount = 0;
+	}
+	
+	std::optional<RaycastHit> SpatialIndex::raycast(Ray const& ray, float maxDistance) const {
+		std::optional<RaycastHit> result;
+		raycast(ray, maxDistance, [&](EntityID entity, float distance) {
+			result = RaycastHit{ entity, distance };
+			return distance;
+		});
+		return result;
+	}
+	
+	/// MARK: Private
+	std::int32_t SpatialIndex::allocateNode() {
+		if (mFreeList == nullNode) {
+			mNodes.emplace_back();
+			return static_cast<std::int32_t>(mNodes.size() - 1);
+		}
+		std::int32_t const result = mFreeList;
+		mFreeList = mNodes[result].parent;
+		mNodes[result] = Node{};
+		return result;
+	}
+	
+	void SpatialIndex::freeNode(std::int32_t index) {
+		mNodes[index].parent = mFreeList;
+		mNodes[index].height = -1;
+		mFreeList = index;
+	}
+	
+	void SpatialIndex::insertLeaf(std::int32_t leaf) {
+		if (mRoot == nullNode) {
+			mRoot = leaf;
+			mNodes[leaf].parent = nullNode;
+			return;
+		}
+		
+		// Descend towards the sibling with the lowest cost. Every inner node on the way grows to contain the leaf.
+		AABB const leafBounds = mNodes[leaf].bounds;
+		std::int32_t index = mRoot;
+		while (!mNodes[index].isLeaf()) {
+			Node const& node = mNodes[index];
+			float const area = node.bounds.surfaceArea();
+			float const combinedArea = merge(node.bounds, leafBounds).surfaceArea();
+			// Cost of making a new parent for this node and the leaf.
+			float const cost = 2 * combinedArea;
+			// Minimum cost of pushing the leaf further down.
+			float const inheritanceCost = 2 * (combinedArea - area);
+			auto descendCost = [&](std::int32_t child) {
+				Node const& c = mNodes[child];
+				float const merged = merge(leafBounds, c.bounds).surfaceArea();
+				return inheritanceCost + (c.isLeaf() ? merged : merged - c.bounds.surfaceArea());
+			};
+			float const cost1 = descendCost(node.child1);
+			float const cost2 = descendCost(node.child2);
+			if (cost < cost1 && cost < cost2) {
+				break;
+			}
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+		
+		std::int32_t const sibling = index;
+		std::int32_t const oldParent = mNodes[sibling].parent;
+		std::int32_t const newParent = allocateNode();
+		mNodes[newParent].parent = oldParent;
+		mNodes[newParent].bounds = merge(leafBounds, mNodes[sibling].bounds);
+		mNodes[newParent].height = mNodes[sibling].height + 1;
+		mNodes[newParent].child1 = sibling;
+		mNodes[newParent].child2 = leaf;
+		mNodes[sibling].parent = newParent;
+		mNodes[leaf].parent = newParent;
+		if (oldParent != nullNode) {
+			if (mNodes[oldParent].child1 == sibling) {
+				mNodes[oldParent].child1 = newParent;
+			}
+			else {
+				mNodes[oldParent].child2 = newParent;
+			}
+		}
+		else {
+			mRoot = newParent;
+		}
+		
+		refit(mNodes[leaf].parent);
+	}
+	
+	void SpatialIndex::removeLeaf(std::int32_t leaf) {
+		if (leaf == mRoot) {
+			mRoot = nullNode;
+			return;
+		}
+		std::int32_t const parent = mNodes[leaf].parent;
+		std::int32_t const grandParent = mNodes[parent].parent;
+		std::int32_t const sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+		
+		mNodes[sibling].parent = grandParent;
+		freeNode(parent);
+		if (grandParent == nullNode) {
+			mRoot = sibling;
+			return;
+		}
+		if (mNodes[grandParent].child1 == parent) {
+			mNodes[grandParent].child1 = sibling;
+		}
+		else {
+			mNodes[grandParent].child2 = sibling;
+		}
+		refit(grandParent);
+	}
+	
+	/// Rebalances and recomputes bounds and heights from \p index up to the root.
+	void SpatialIndex::refit(std::int32_t index) {
+		while (index != nullNode) {
+			index = balance(index);
+			Node& node = mNodes[index];
+			Node const& child1 = mNodes[node.child1];
+			Node const& child2 = mNodes[node.child2];
+			node.height = 1 + std::max(child1.height, child2.height);
+			node.bounds = merge(child1.bounds, child2.bounds);
+			index = node.parent;
+		}
+	}
+	
+	/// Rotates the taller child of \p iA up if the heights of its children differ by more than one.
+	/// Returns the index of the node now at the position of \p iA.
+	std::int32_t SpatialIndex::balance(std::int32_t iA) {
+		Node& A = mNodes[iA];
+		if (A.isLeaf() || A.height < 2) {
+			return iA;
+		}
+		std::int32_t const iB = A.child1;
+		std::int32_t const iC = A.child2;
+		Node& B = mNodes[iB];
+		Node& C = mNodes[iC];
+		int const balance = C.height - B.height;
+		
+		// Makes the child at iUp the parent of iA, in place of iA.
+		auto rotateUp = [&](std::int32_t iUp, Node& up) {
+			up.child1 = iA;
+			up.parent = A.parent;
+			A.parent = iUp;
+			if (up.parent == nullNode) {
+				mRoot = iUp;
+			}
+			else if (mNodes[up.parent].child1 == iA) {
+				mNodes[up.parent].child1 = iUp;
+			}
+			else {
+				bloomAssert(mNodes[up.parent].child2 == iA);
+				mNodes[up.parent].child2 = iUp;
+			}
+		};
+		
+		if (balance > 1) {
+			std::int32_t const iF = C.child1;
+			std::int32_t const iG = C.child2;
+			Node& F = mNodes[iF];
+			Node& G = mNodes[iG];
+			rotateUp(iC, C);
+			if (F.height > G.height) {
+				C.child2 = iF;
+				A.child2 = iG;
+				G.parent = iA;
+				A.bounds = merge(B.bounds, G.bounds);
+				C.bounds = merge(A.bounds, F.bounds);
+				A.height = 1 + std::max(B.height, G.height);
+				C.height = 1 + std::max(A.height, F.height);
+			}
+			else {
+				C.child2 = iG;
+				A.child2 = iF;
+				F.parent = iA;
+				A.bounds = merge(B.bounds, F.bounds);
+				C.bounds = merge(A.bounds, G.bounds);
+				A.height = 1 + std::max(B.height, F.height);
+				C.height = 1 + std::max(A.height, G.height);
+			}
+			return iC;
+		}
+		
+		if (balance < -1) {
+			std::int32_t const iD = B.child1;
+			std::int32_t const iE = B.child2;
+			Node& D = mNodes[iD];
+			Node& E = mNodes[iE];
+			rotateUp(iB, B);
+			if (D.height > E.height) {
+				B.child2 = iD;
+				A.child1 = iE;
+				E.parent = iA;
+				A.bounds = merge(C.bounds, E.bounds);
+				B.bounds = merge(A.bounds, D.bounds);
+				A.height = 1 + std::max(C.height, E.height);
+				B.height = 1 + std::max(A.height, D.height);
+			}
+			else {
+				B.child2 = iE;
+				A.child1 = iD;
+				D.parent = iA;
+				A.bounds = merge(C.bounds, D.bounds);
+				B.bounds = merge(A.bounds, E.bounds);
+				A.height = 1 + std::max(C.height, D.height);
+				B.height = 1 + std::max(A.height, E.height);
+			}
+			return iB;
+		}
+		
+		return iA;
+	}
+	
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Bloom/Core/Base.hpp"
+#include "Bloom/Core/Geometry.hpp"
+
+#include "Entity.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <utl/vector.hpp>
+
+namespace bloom {
+	
+	struct BLOOM_API RaycastHit {
+		EntityID entity;
+		float distance;
+	};
+	
+	/// Dynamic AABB tree over entity bounds.
+	/// Leaves store a fat box grown by \p margin, so objects that move a little do not touch the tree at all.
+	/// Insertion picks the sibling with the lowest surface area cost and the tree is kept balanced with rotations.
+	class BLOOM_API SpatialIndex {
+	public:
+		using ProxyID = std::int32_t;
+		static constexpr ProxyID nullProxy = -1;
+		
+		explicit SpatialIndex(float margin = 0.1f): mMargin(margin) {}
+		
+		ProxyID insert(AABB const& bounds, EntityID entity);
+		void remove(ProxyID);
+		
+		/// Sets the bounds of \p proxy. Returns true if the proxy had to be reinserted into the tree.
+		bool update(ProxyID proxy, AABB const& bounds);
+		
+		void clear();
+		
+		std::size_t size() const { return mLeafCount; }
+		bool empty() const { return mLeafCount == 0; }
+		
+		/// Height of the tree, 0 for a single leaf.
+		int height() const { return mRoot == nullNode ? 0 : mNodes[mRoot].height; }
+		
+		EntityID entity(ProxyID proxy) const { return mNodes[proxy].entity; }
+		AABB const& bounds(ProxyID proxy) const { return mNodes[proxy].tightBounds; }
+		
+		/// MARK: Queries
+		/// Invokes \p f(EntityID) for every entity whose bounds overlap the query volume.
+		template <typename F>
+		void query(AABB const& box, F&& f) const {
+			traverse([&](AABB const& nodeBounds) { return intersects(nodeBounds, box); }, f);
+		}
+		
+		template <typename F>
+		void query(Sphere const& sphere, F&& f) const {
+			traverse([&](AABB const& nodeBounds) { return intersects(nodeBounds, sphere); }, f);
+		}
+		
+		/// Subtrees that lie completely inside of \p frustum are reported without testing their leaves.
+		template <typename F>
+		void query(Frustum const& frustum, F&& f) const;
+		
+		/// Invokes \p f(EntityID, float distance) for entities hit by \p ray, in no particular order.
+		/// \p f returns the distance to clip the ray to, return \p distance to only look for closer hits.
+		template <typename F>
+		void raycast(Ray const& ray, float maxDistance, F&& f) const;
+		
+		/// Closest entity whose bounds are hit by \p ray.
+		std::optional<RaycastHit> raycast(Ray const& ray, float maxDistance = std::numeric_limits<float>::max()) const;
+	
+	private:
+		static constexpr std::int32_t nullNode = -1;
+		
+		struct Node {
+			/// Fat bounds for leaves, union of the children for inner nodes.
+			AABB bounds;
+			/// Exact bounds of the entity. Only used by leaves.
+			AABB tightBounds;
+			/// Next free node while the node is unused.
+			std::int32_t parent = nullNode;
+			std::int32_t child1 = nullNode, child2 = nullNode;
+			/// -1 for free nodes.
+			std::int32_t height = -1;
+			EntityID entity;
+			
+			bool isLeaf() const { return child1 == nullNode; }
+		};
+		
+		std::int32_t allocateNode();
+		void freeNode(std::int32_t);
+		void insertLeaf(std::int32_t leaf);
+		void removeLeaf(std::int32_t leaf);
+		std::int32_t balance(std::int32_t);
+		void refit(std::int32_t index);
+		
+		template <typename Overlaps, typename F>
+		void traverse(Overlaps&& overlaps, F& f) const;
+	
+	private:
+		utl::vector<Node> mNodes;
+		std::int32_t mRoot = nullNode;
+		std::int32_t mFreeList = nullNode;
+		std::size_t mLeafCount = 0;
+		float mMargin;
+	};
+	
+	template <typename Overlaps, typename F>
+	void SpatialIndex::traverse(Overlaps&& overlaps, F& f) const {
+		if (mRoot == nullNode) {
+			return;
+		}
+		utl::small_vector<std::int32_t, 64> stack;
+		stack.push_back(mRoot);
+		while (!stack.empty()) {
+			Node const& node = mNodes[stack.back()];
+			stack.pop_back();
+			if (!overlaps(node.bounds)) {
+				continue;
+			}
+			if (node.isLeaf()) {
+				if (overlaps(node.tightBounds)) {
+					f(node.entity);
+				}
+				continue;
+			}
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+	
+	template <typename F>
+	void SpatialIndex::query(Frustum const& frustum, F&& f) const {
+		if (mRoot == nullNode) {
+			return;
+		}
+		// Second component is true if the node is known to be inside.
+		utl::small_vector<std::pair<std::int32_t, bool>, 64> stack;
+		stack.push_back({ mRoot, false });
+		while (!stack.empty()) {
+			auto const [index, inside] = stack.back();
+			stack.pop_back();
+			Node const& node = mNodes[index];
+			if (node.isLeaf()) {
+				if (inside || frustum.classify(node.tightBounds) != Containment::outside) {
+					f(node.entity);
+				}
+				continue;
+			}
+			bool childrenInside = inside;
+			if (!inside) {
+				Containment const containment = frustum.classify(node.bounds);
+				if (containment == Containment::outside) {
+					continue;
+				}
+				childrenInside = containment == Containment::inside;
+			}
+			stack.push_back({ node.child1, childrenInside });
+			stack.push_back({ node.child2, childrenInside });
+		}
+	}
+	
+	template <typename F>
+	void SpatialIndex::raycast(Ray const& ray, float maxDistance, F&& f) const {
+		if (mRoot == nullNode) {
+			return;
+		}
+		utl::small_vector<std::int32_t, 64> stack;
+		stack.push_back(mRoot);
+		while (!stack.empty()) {
+			Node const& node = mNodes[stack.back()];
+			stack.pop_back();
+			if (!intersect(ray, node.bounds, maxDistance)) {
+				continue;
+			}
+			if (node.isLeaf()) {
+				if (auto const distance = intersect(ray, node.tightBounds, maxDistance)) {
+					maxDistance = f(node.entity, *distance);
+				}
+				continue;
+			}
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+	
+}
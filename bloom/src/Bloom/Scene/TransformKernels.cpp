@@ -0,0 +1,311 @@
+#include "TransformKernels.hpp"
+
+#include "Bloom/Core/Debug.hpp"
+
+#include "Components/Transform.hpp"
+
+#include <algorithm>
+
+// The vectorized kernels rely on GCC/Clang vector extensions and target attributes.
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#	define BLOOM_X86_KERNELS
+#	define BLOOM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#	define BLOOM_ALWAYS_INLINE __attribute__((always_inline)) inline
+#	include <immintrin.h>
+#endif
+
+namespace bloom {
+	
+	// The vectorized kernels treat matrices as 16 floats stored row by row, which is how mtl lays them out.
+	static_assert(sizeof(mtl::float4x4) == 16 * sizeof(float));
+	
+	[[ maybe_unused ]] static float* elements(mtl::float4x4* m) { return reinterpret_cast<float*>(m); }
+	[[ maybe_unused ]] static float const* elements(mtl::float4x4 const* m) { return reinterpret_cast<float const*>(m); }
+	
+	SIMDPath bestSIMDPath() {
+#if defined(BLOOM_X86_KERNELS)
+		static SIMDPath const result = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ?
+			SIMDPath::avx2 : SIMDPath::sse;
+		return result;
+#else
+		return SIMDPath::scalar;
+#endif
+	}
+	
+	char const* toString(SIMDPath path) {
+		switch (path) {
+			case SIMDPath::scalar: return "scalar";
+			case SIMDPath::sse:    return "SSE";
+			case SIMDPath::avx2:   return "AVX2";
+		}
+		return "";
+	}
+	
+	/// MARK: Scalar
+	static void calculateTransformsScalar(Transform const* transforms, mtl::float4x4* result, std::size_t count) {
+		for (std::size_t i = 0; i < count; ++i) {
+			result[i] = transforms[i].calculate();
+		}
+	}
+	
+	static void multiplyMatricesScalar(mtl::float4x4 const& lhs, mtl::float4x4 const* rhs, mtl::float4x4* result, std::size_t count) {
+		for (std::size_t i = 0; i < count; ++i) {
+			result[i] = lhs * rhs[i];
+		}
+	}
+	
+	static void transposeMatricesScalar(mtl::float4x4 const* matrices, mtl::float4x4* result, std::size_t count) {
+		for (std::size_t i = 0; i < count; ++i) {
+			result[i] = mtl::transpose(matrices[i]);
+		}
+	}
+
+#if defined(BLOOM_X86_KERNELS)
+	
+	/// MARK: Structure of arrays
+	/// Transforms are processed in blocks of \p blockSize. Every block is converted into one array per scalar input
+	/// and one array per non-constant matrix element, so a register holds the same quantity of several transforms.
+	static constexpr std::size_t blockSize = 8;
+	
+	namespace {
+		enum TransformInput {
+			px, py, pz, qr, qi, qj, qk, sx, sy, sz, inputCount
+		};
+		
+		struct alignas(32) TransformBlock {
+			float input[inputCount][blockSize];
+			/// Upper three rows of the resulting matrices. The last row is always (0, 0, 0, 1).
+			float output[12][blockSize];
+		};
+		
+		/// Vector extensions let one formula serve both register widths.
+		/// The instruction set is determined by the target of the calling kernel.
+		typedef float Float4 __attribute__((vector_size(16), may_alias));
+		typedef float Float8 __attribute__((vector_size(32), may_alias));
+	}
+	
+	static void loadBlock(TransformBlock& block, Transform const* transforms, std::size_t count) {
+		for (std::size_t i = 0; i < count; ++i) {
+			Transform const& t = transforms[i];
+			block.input[px][i] = t.position.x;
+			block.input[py][i] = t.position.y;
+			block.input[pz][i] = t.position.z;
+			block.input[qr][i] = t.orientation.real();
+			block.input[qi][i] = t.orientation.imag();
+			block.input[qj][i] = t.orientation.jmag();
+			block.input[qk][i] = t.orientation.kmag();
+			block.input[sx][i] = t.scale.x;
+			block.input[sy][i] = t.scale.y;
+			block.input[sz][i] = t.scale.z;
+		}
+		// Pad partial blocks with identity transforms, their results are discarded.
+		for (std::size_t i = count; i < blockSize; ++i) {
+			for (int j = 0; j < inputCount; ++j) {
+				block.input[j][i] = 0;
+			}
+			block.input[qr][i] = 1;
+			block.input[sx][i] = block.input[sy][i] = block.input[sz][i] = 1;
+		}
+	}
+	
+	/// Evaluates translation * rotation * scale lane wise.
+	/// Always inlined, so the wide instantiation is compiled for the target of its caller.
+	template <typename V>
+	BLOOM_ALWAYS_INLINE static void calculateBlock(TransformBlock& block, std::size_t laneOffset) {
+		auto in = [&](int input) -> V const& {
+			return *reinterpret_cast<V const*>(&block.input[input][laneOffset]);
+		};
+		auto out = [&](int element) -> V& {
+			return *reinterpret_cast<V*>(&block.output[element][laneOffset]);
+		};
+		
+		V const w = in(qr), x = in(qi), y = in(qj), z = in(qk);
+		V const x2 = x * 2.0f, y2 = y * 2.0f, z2 = z * 2.0f;
+		V const xx = x * x2, yy = y * y2, zz = z * z2;
+		V const xy = x * y2, xz = x * z2, yz = y * z2;
+		V const wx = w * x2, wy = w * y2, wz = w * z2;
+		V const scaleX = in(sx), scaleY = in(sy), scaleZ = in(sz);
+		
+		out(0) = (1.0f - (yy + zz)) * scaleX;
+		out(1) = (xy - wz) * scaleY;
+		out(2) = (xz + wy) * scaleZ;
+		out(3) = in(px);
+		
+		out(4) = (xy + wz) * scaleX;
+		out(5) = (1.0f - (xx + zz)) * scaleY;
+		out(6) = (yz - wx) * scaleZ;
+		out(7) = in(py);
+		
+		out(8) = (xz - wy) * scaleX;
+		out(9) = (yz + wx) * scaleY;
+		out(10) = (1.0f - (xx + yy)) * scaleZ;
+		out(11) = in(pz);
+	}
+	
+	/// Converts four lanes of the output arrays back into rows of four matrices.
+	static void storeBlock(TransformBlock const& block, std::size_t laneOffset, mtl::float4x4* result, std::size_t count) {
+		__m128 const lastRow = _mm_setr_ps(0, 0, 0, 1);
+		for (int row = 0; row < 3; ++row) {
+			__m128 r0 = _mm_load_ps(&block.output[4 * row + 0][laneOffset]);
+			__m128 r1 = _mm_load_ps(&block.output[4 * row + 1][laneOffset]);
+			__m128 r2 = _mm_load_ps(&block.output[4 * row + 2][laneOffset]);
+			__m128 r3 = _mm_load_ps(&block.output[4 * row + 3][laneOffset]);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			__m128 const rows[4] = { r0, r1, r2, r3 };
+			for (std::size_t i = 0; i < count; ++i) {
+				_mm_storeu_ps(elements(&result[i]) + 4 * row, rows[i]);
+			}
+		}
+		for (std::size_t i = 0; i < count; ++i) {
+			_mm_storeu_ps(elements(&result[i]) + 12, lastRow);
+		}
+	}
+	
+	/// MARK: SSE
+	static void calculateTransformsSSE(Transform const* transforms, mtl::float4x4* result, std::size_t count) {
+		TransformBlock block;
+		for (std::size_t begin = 0; begin < count; begin += blockSize) {
+			std::size_t const blockCount = std::min(blockSize, count - begin);
+			loadBlock(block, transforms + begin, blockCount);
+			for (std::size_t lane = 0; lane < blockCount; lane += 4) {
+				calculateBlock<Float4>(block, lane);
+				storeBlock(block, lane, result + begin + lane, std::min<std::size_t>(4, blockCount - lane));
+			}
+		}
+	}
+	
+	/// Row \p i of lhs * rhs is the sum of the rows of rhs weighted by the elements of row \p i of lhs.
+	/// The broadcast elements of \p lhs are shared by all matrices of the batch.
+	static void multiplyMatricesSSE(mtl::float4x4 const& lhs, mtl::float4x4 const* rhs, mtl::float4x4* result, std::size_t count) {
+		float const* const a = elements(&lhs);
+		__m128 weights[4][4];
+		for (int row = 0; row < 4; ++row) {
+			for (int k = 0; k < 4; ++k) {
+				weights[row][k] = _mm_set1_ps(a[4 * row + k]);
+			}
+		}
+		for (std::size_t i = 0; i < count; ++i) {
+			float const* const b = elements(&rhs[i]);
+			__m128 const b0 = _mm_loadu_ps(b + 0);
+			__m128 const b1 = _mm_loadu_ps(b + 4);
+			__m128 const b2 = _mm_loadu_ps(b + 8);
+			__m128 const b3 = _mm_loadu_ps(b + 12);
+			float* const c = elements(&result[i]);
+			for (int row = 0; row < 4; ++row) {
+				__m128 const sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(weights[row][0], b0), _mm_mul_ps(weights[row][1], b1)),
+											  _mm_add_ps(_mm_mul_ps(weights[row][2], b2), _mm_mul_ps(weights[row][3], b3)));
+				_mm_storeu_ps(c + 4 * row, sum);
+			}
+		}
+	}
+	
+	static void transposeMatricesSSE(mtl::float4x4 const* matrices, mtl::float4x4* result, std::size_t count) {
+		for (std::size_t i = 0; i < count; ++i) {
+			float const* const m = elements(&matrices[i]);
+			__m128 r0 = _mm_loadu_ps(m + 0);
+			__m128 r1 = _mm_loadu_ps(m + 4);
+			__m128 r2 = _mm_loadu_ps(m + 8);
+			__m128 r3 = _mm_loadu_ps(m + 12);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			float* const t = elements(&result[i]);
+			_mm_storeu_ps(t + 0, r0);
+			_mm_storeu_ps(t + 4, r1);
+			_mm_storeu_ps(t + 8, r2);
+			_mm_storeu_ps(t + 12, r3);
+		}
+	}
+	
+	/// MARK: AVX2
+	BLOOM_TARGET_AVX2
+	static void calculateTransformsAVX2(Transform const* transforms, mtl::float4x4* result, std::size_t count) {
+		TransformBlock block;
+		for (std::size_t begin = 0; begin < count; begin += blockSize) {
+			std::size_t const blockCount = std::min(blockSize, count - begin);
+			loadBlock(block, transforms + begin, blockCount);
+			calculateBlock<Float8>(block, 0);
+			for (std::size_t lane = 0; lane < blockCount; lane += 4) {
+				storeBlock(block, lane, result + begin + lane, std::min<std::size_t>(4, blockCount - lane));
+			}
+		}
+	}
+	
+	/// Computes two rows per instruction: the low half of a register belongs to row \p 2i, the high half to row \p 2i+1.
+	BLOOM_TARGET_AVX2
+	static void multiplyMatricesAVX2(mtl::float4x4 const& lhs, mtl::float4x4 const* rhs, mtl::float4x4* result, std::size_t count) {
+		float const* const a = elements(&lhs);
+		__m256 weights[2][4];
+		for (int rowPair = 0; rowPair < 2; ++rowPair) {
+			__m256 const rows = _mm256_loadu_ps(a + 8 * rowPair);
+			weights[rowPair][0] = _mm256_shuffle_ps(rows, rows, 0x00);
+			weights[rowPair][1] = _mm256_shuffle_ps(rows, rows, 0x55);
+			weights[rowPair][2] = _mm256_shuffle_ps(rows, rows, 0xAA);
+			weights[rowPair][3] = _mm256_shuffle_ps(rows, rows, 0xFF);
+		}
+		for (std::size_t i = 0; i < count; ++i) {
+			float const* const b = elements(&rhs[i]);
+			__m256 const b0 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(b + 0));
+			__m256 const b1 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(b + 4));
+			__m256 const b2 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(b + 8));
+			__m256 const b3 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(b + 12));
+			float* const c = elements(&result[i]);
+			for (int rowPair = 0; rowPair < 2; ++rowPair) {
+				__m256 sum = _mm256_mul_ps(weights[rowPair][0], b0);
+				sum = _mm256_fmadd_ps(weights[rowPair][1], b1, sum);
+				sum = _mm256_fmadd_ps(weights[rowPair][2], b2, sum);
+				sum = _mm256_fmadd_ps(weights[rowPair][3], b3, sum);
+				_mm256_storeu_ps(c + 8 * rowPair, sum);
+			}
+		}
+	}
+
+#endif // BLOOM_X86_KERNELS
+	
+	/// MARK: Dispatch
+	void calculateTransforms(Transform const* transforms, mtl::float4x4* result, std::size_t count, SIMDPath path) {
+		switch (path) {
+#if defined(BLOOM_X86_KERNELS)
+			case SIMDPath::avx2:
+				calculateTransformsAVX2(transforms, result, count);
+				return;
+			case SIMDPath::sse:
+				calculateTransformsSSE(transforms, result, count);
+				return;
+#endif
+			default:
+				calculateTransformsScalar(transforms, result, count);
+				return;
+		}
+	}
+	
+	void multiplyMatrices(mtl::float4x4 const& lhs, mtl::float4x4 const* rhs, mtl::float4x4* result, std::size_t count, SIMDPath path) {
+		switch (path) {
+#if defined(BLOOM_X86_KERNELS)
+			case SIMDPath::avx2:
+				multiplyMatricesAVX2(lhs, rhs, result, count);
+				return;
+			case SIMDPath::sse:
+				multiplyMatricesSSE(lhs, rhs, result, count);
+				return;
+#endif
+			default:
+				multiplyMatricesScalar(lhs, rhs, result, count);
+				return;
+		}
+	}
+	
+	void transposeMatrices(mtl::float4x4 const* matrices, mtl::float4x4* result, std::size_t count, SIMDPath path) {
+		switch (path) {
+#if defined(BLOOM_X86_KERNELS)
+			// A 4x4 transpose is four shuffles per matrix already, wider registers do not help.
+			case SIMDPath::avx2:
+			case SIMDPath::sse:
+				transposeMatricesSSE(matrices, result, count);
+				return;
+#endif
+			default:
+				transposeMatricesScalar(matrices, result, count);
+				return;
+		}
+	}
+	
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Bloom/Core/Base.hpp"
+
+#include <mtl/mtl.hpp>
+#include <cstddef>
+
+namespace bloom {
+	
+	struct Transform;
+	
+	/// Instruction set used by the batch transform kernels.
+	enum class BLOOM_API SIMDPath {
+		scalar, sse, avx2
+	};
+	
+	/// Widest path supported by the executing CPU.
+	BLOOM_API SIMDPath bestSIMDPath();
+	
+	BLOOM_API char const* toString(SIMDPath);
+	
+	/// Writes \p transforms[i].calculate() into \p result[i] for \p count transforms.
+	/// The vectorized paths convert the transforms into structure of arrays form and compute 4 or 8 matrices at a time.
+	BLOOM_API void calculateTransforms(Transform const* transforms, mtl::float4x4* result, std::size_t count,
+									   SIMDPath = bestSIMDPath());
+	
+	/// Writes \p lhs * \p rhs[i] into \p result[i] for \p count matrices. \p result may alias \p rhs.
+	BLOOM_API void multiplyMatrices(mtl::float4x4 const& lhs, mtl::float4x4 const* rhs, mtl::float4x4* result, std::size_t count,
+									SIMDPath = bestSIMDPath());
+	
+	/// Writes the transpose of \p matrices[i] into \p result[i] for \p count matrices. \p result may alias \p matrices.
+	BLOOM_API void transposeMatrices(mtl::float4x4 const* matrices, mtl::float4x4* result, std::size_t count,
+									 SIMDPath = bestSIMDPath());
+	
+}
@@ -0,0 +1,47 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Asset/AssetRegistry.hpp"
+
+#include <sstream>
+
+using namespace bloom;
+
+TEST_CASE("AssetRegistry round trip") {
+	AssetRegistry registry;
+	auto const handle = AssetHandle::generate(AssetType::scene);
+	registry.insert("Scenes/Level.bscene", { .modificationTime = 42, .size = 1024, .handle = handle, .name = "Level" });
+	registry.insert("Meshes/Cube.bmesh", { .modificationTime = 7, .size = 512, .handle = AssetHandle::generate(AssetType::staticMesh), .name = "Cube" });
+	
+	std::stringstream stream;
+	registry.write(stream);
+	AssetRegistry loaded;
+	loaded.read(stream);
+	REQUIRE(loaded.size() == 2);
+	
+	auto const* entry = loaded.find("Scenes/Level.bscene", 42, 1024);
+	REQUIRE(entry);
+	CHECK(entry->handle == handle);
+	CHECK(entry->name == "Level");
+	
+	// A file that changed since it was registered is not answered from the cache.
+	CHECK(!loaded.find("Scenes/Level.bscene", 43, 1024));
+	CHECK(!loaded.find("Scenes/Level.bscene", 42, 1000));
+	CHECK(!loaded.find("Scenes/Other.bscene", 42, 1024));
+}
+
+TEST_CASE("AssetRegistry discards invalid caches") {
+	AssetRegistry registry;
+	registry.insert("Scenes/Level.bscene", { .modificationTime = 42, .size = 1024, .name = "Level" });
+	std::stringstream stream;
+	registry.write(stream);
+	
+	std::string truncated = stream.str();
+	truncated.resize(truncated.size() - 3);
+	std::stringstream truncatedStream(truncated);
+	registry.read(truncatedStream);
+	CHECK(registry.size() == 0);
+	
+	std::stringstream garbage("not a registry");
+	registry.read(garbage);
+	CHECK(registry.size() == 0);
+}
@@ -0,0 +1,79 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Core/InternedString.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bloom;
+
+TEST_CASE("StringTable shares equal strings") {
+	StringTable table;
+	InternedString const a = table.intern("Name");
+	InternedString const b = table.intern(std::string("Na") + "me");
+	CHECK(a.c_str() == b.c_str());
+	CHECK(a == b);
+	CHECK(a == "Name");
+	CHECK(table.find("Name") == a);
+	CHECK(table.find("Other").empty());
+	CHECK(table.size() == 1);
+}
+
+TEST_CASE("StringTable releases strings nothing refers to") {
+	StringTable table;
+	InternedString name;
+	// Like renaming an entity on every keystroke.
+	for (int i = 0; i < 10'000; ++i) {
+		name = table.intern("Entity " + std::to_string(i));
+	}
+	CHECK(table.size() <= 128);
+	CHECK(name == "Entity 9999");
+	table.sweep();
+	CHECK(table.size() == 1);
+}
+
+TEST_CASE("StringTable adopts handles of other tables") {
+	StringTable source;
+	InternedString name = source.intern("Name");
+	InternedString const detached = "Detached";
+	StringTable copy = source.copy();
+	
+	InternedString adopted = name;
+	copy.adopt(adopted);
+	CHECK(adopted == name);
+	CHECK(adopted.c_str() != name.c_str());
+	CHECK(adopted.c_str() == copy.find("Name").c_str());
+	
+	InternedString other = detached;
+	copy.adopt(other);
+	CHECK(other.c_str() == copy.find("Detached").c_str());
+	CHECK(copy.size() == 2);
+}
+
+TEST_CASE("InternedString outlives its table") {
+	InternedString name;
+	{
+		StringTable table;
+		name = table.intern("Name");
+	}
+	CHECK(name == "Name");
+	
+	// Handles are copied and destroyed on other threads, like components of a scene copy.
+	StringTable table;
+	InternedString const shared = table.intern("Shared");
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i) {
+		threads.emplace_back([&]{
+			for (int j = 0; j < 1000; ++j) {
+				InternedString const copy = shared;
+				(void)copy;
+			}
+		});
+	}
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	table.sweep();
+	CHECK(table.find("Shared") == shared);
+}
@@ -0,0 +1,166 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Core/TaskGraph.hpp"
+#include "Bloom/Core/ThreadPool.hpp"
+#include "Bloom/Runtime/JobSystem.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace bloom;
+
+TEST_CASE("ThreadPool submit", "[job-system]") {
+	std::size_t const workerCount = GENERATE(0, 1, 4);
+	ThreadPool threadPool(workerCount);
+	std::size_t const count = 10'000;
+	std::atomic_size_t pending = count;
+	std::atomic_size_t sum = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		threadPool.submit([&, i]{
+			sum += i;
+			--pending;
+		});
+	}
+	threadPool.wait(pending);
+	CHECK(sum == count * (count - 1) / 2);
+}
+
+TEST_CASE("ThreadPool nested parallelFor", "[job-system]") {
+	ThreadPool threadPool(4);
+	std::size_t const outer = 64, inner = 1000;
+	std::vector<std::size_t> values(outer * inner, 0);
+	threadPool.parallelFor(outer, 1, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			threadPool.parallelFor(inner, 100, [&](std::size_t innerBegin, std::size_t innerEnd) {
+				for (std::size_t j = innerBegin; j < innerEnd; ++j) {
+					++values[i * inner + j];
+				}
+			});
+		}
+	});
+	CHECK(std::accumulate(values.begin(), values.end(), std::size_t(0)) == outer * inner);
+	CHECK(std::all_of(values.begin(), values.end(), [](std::size_t value) { return value == 1; }));
+}
+
+TEST_CASE("ThreadPool concurrent parallelFor", "[job-system]") {
+	ThreadPool threadPool(4);
+	std::atomic_size_t total = 0;
+	auto loop = [&]{
+		for (int k = 0; k < 100; ++k) {
+			threadPool.parallelFor(1000, 10, [&](std::size_t begin, std::size_t end) {
+				total += end - begin;
+			});
+		}
+	};
+	std::thread other(loop);
+	loop();
+	other.join();
+	CHECK(total == 2 * 100 * 1000);
+}
+
+TEST_CASE("ThreadPool fork/join waits only help their own tasks", "[job-system]") {
+	ThreadPool threadPool(1);
+	std::atomic_bool blocked = true, workerBusy = false, unrelatedRan = false;
+	std::atomic_size_t pending = 2;
+	// Keeps the only worker busy, so the waiting thread has to run the tasks it waits for.
+	threadPool.submit([&]{
+		workerBusy = true;
+		while (blocked) {
+			std::this_thread::yield();
+		}
+		--pending;
+	});
+	while (!workerBusy) {
+		std::this_thread::yield();
+	}
+	threadPool.submit([&]{
+		unrelatedRan = true;
+		--pending;
+	});
+	
+	std::atomic_size_t total = 0;
+	threadPool.parallelFor(100, 10, [&](std::size_t begin, std::size_t end) {
+		total += end - begin;
+	});
+	TaskGraph graph;
+	graph.precede(graph.add([&]{ ++total; }), graph.add([&]{ ++total; }));
+	graph.run(threadPool);
+	CHECK(total == 102);
+	CHECK(!unrelatedRan);
+	
+	blocked = false;
+	threadPool.wait(pending);
+	CHECK(unrelatedRan);
+}
+
+TEST_CASE("TaskGraph dependencies", "[job-system]") {
+	std::size_t const workerCount = GENERATE(0, 4);
+	ThreadPool threadPool(workerCount);
+	
+	// Diamond a -> (b, c) -> d followed by a chain of 100 tasks.
+	std::mutex mutex;
+	std::vector<int> order;
+	auto record = [&](int value) {
+		return [&, value]{
+			std::unique_lock lock(mutex);
+			order.push_back(value);
+		};
+	};
+	TaskGraph graph;
+	auto a = graph.add(record(0));
+	auto b = graph.add(record(1));
+	auto c = graph.add(record(1));
+	auto d = graph.add(record(2));
+	graph.precede(a, b);
+	graph.precede(a, c);
+	graph.precede(b, d);
+	graph.precede(c, d);
+	auto previous = d;
+	for (int i = 0; i < 100; ++i) {
+		auto next = graph.add(record(3 + i));
+		graph.precede(previous, next);
+		previous = next;
+	}
+	
+	for (int run = 0; run < 3; ++run) {
+		order.clear();
+		graph.run(threadPool);
+		REQUIRE(order.size() == graph.size());
+		CHECK(std::is_sorted(order.begin(), order.end()));
+	}
+}
+
+TEST_CASE("TaskGraph independent tasks", "[job-system]") {
+	ThreadPool threadPool(4);
+	TaskGraph graph;
+	std::atomic_size_t count = 0;
+	for (int i = 0; i < 1000; ++i) {
+		graph.add([&]{ ++count; });
+	}
+	graph.run(threadPool);
+	CHECK(count == 1000);
+}
+
+TEST_CASE("JobSystem main thread continuations", "[job-system]") {
+	JobSystem jobSystem(2);
+	auto const mainThread = std::this_thread::get_id();
+	std::atomic_int jobs = 0;
+	int continuations = 0;
+	bool continuationsOnMainThread = true;
+	for (int i = 0; i < 100; ++i) {
+		jobSystem.submit([&]{ ++jobs; }, [&]{
+			++continuations;
+			continuationsOnMainThread &= std::this_thread::get_id() == mainThread;
+		});
+	}
+	jobSystem.waitIdle();
+	CHECK(jobs == 100);
+	CHECK(continuations == 0);
+	
+	jobSystem.runMainThreadTasks();
+	CHECK(continuations == 100);
+	CHECK(continuationsOnMainThread);
+}
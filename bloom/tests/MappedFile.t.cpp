@@ -0,0 +1,43 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Core/MappedFile.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+using namespace bloom;
+
+TEST_CASE("MappedFile maps the contents of a file") {
+	auto const path = std::filesystem::temp_directory_path() / "bloom-mapped-file-test.bin";
+	std::string_view const contents = "mapped file contents";
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(contents.data(), contents.size());
+	}
+	
+	{
+		MappedFile const mapped(path);
+		REQUIRE(mapped.size() == contents.size());
+		CHECK(std::memcmp(mapped.data().data(), contents.data(), contents.size()) == 0);
+		
+		// Replacing the file does not affect an existing mapping.
+		auto const replacement = std::filesystem::path(path).concat(".tmp");
+		{
+			std::ofstream file(replacement, std::ios::binary | std::ios::trunc);
+			file << "other";
+		}
+		std::filesystem::rename(replacement, path);
+		CHECK(std::memcmp(mapped.data().data(), contents.data(), contents.size()) == 0);
+	}
+	
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	}
+	CHECK(MappedFile(path).data().empty());
+	
+	std::filesystem::remove(path);
+	CHECK_THROWS_AS(MappedFile(path), std::runtime_error);
+}
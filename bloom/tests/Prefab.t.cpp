@@ -0,0 +1,119 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Scene/Prefab.hpp"
+#include "Bloom/Scene/Scene.hpp"
+
+#include <string>
+
+using namespace bloom;
+
+namespace {
+	/// Prefab with a root and the children "A" and "B", "A" has a child "C".
+	Reference<Prefab> makePrefab() {
+		Scene source(AssetHandle::generate(AssetType::scene), "Source");
+		auto const root = source.createEntity("Root");
+		auto const a = source.createEntity("A");
+		auto const b = source.createEntity("B");
+		auto const c = source.createEntity("C");
+		source.parent(a, root);
+		source.parent(b, root);
+		source.parent(c, a);
+		a.get<Transform>().position = { 0, 2, 0 };
+		source.markTransformDirty(a);
+		
+		auto prefab = allocateRef<Prefab>(AssetHandle::generate(AssetType::prefab), "Prefab");
+		prefab->setTemplate(source, root);
+		return prefab;
+	}
+	
+	YAML::Node findNode(YAML::Node const& root, EntityID id) {
+		for (YAML::Node const& node: root) {
+			if (node["ID"].as<EntityID::RawType>() == id.raw()) {
+				return node;
+			}
+		}
+		return YAML::Node();
+	}
+}
+
+TEST_CASE("Prefab template order") {
+	auto const prefab = makePrefab();
+	auto const& scene = prefab->scene();
+	REQUIRE(prefab->entities().size() == 4);
+	std::string names;
+	for (auto const entity: prefab->entities()) {
+		names += std::string_view(scene.getComponent<TagComponent>(entity).name);
+	}
+	CHECK(names == "RootACB");
+	CHECK(!scene.getComponent<HierarchyComponent>(prefab->entities()[0]).parent);
+}
+
+TEST_CASE("Prefab instantiation") {
+	auto const prefab = makePrefab();
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const parent = scene.createEntity("Parent");
+	
+	auto const first = scene.instantiate(prefab);
+	auto const second = scene.instantiate(prefab);
+	scene.parent(second, parent);
+	
+	auto const& instance = second.get<PrefabInstanceComponent>();
+	REQUIRE(instance.entities.size() == 4);
+	CHECK(instance.entities[0] == second);
+	CHECK(instance.prefab == prefab);
+	CHECK(scene.getComponent<HierarchyComponent>(second).parent == parent);
+	CHECK(!scene.getComponent<HierarchyComponent>(first).parent);
+	
+	// Links point into the instance, not into the template or the other instance.
+	auto const a = instance.entities[1];
+	CHECK(scene.getComponent<HierarchyComponent>(a).parent == second);
+	CHECK(scene.getComponent<HierarchyComponent>(a).firstChild == instance.entities[2]);
+	CHECK(scene.getComponent<TagComponent>(instance.entities[3]).name == "B");
+	CHECK(scene.findEntities("A").size() == 2);
+	
+	scene.applyTransformHierarchy();
+	CHECK(scene.getComponent<TransformMatrixComponent>(instance.entities[2]).matrix.column(3)[1] == Approx(2));
+}
+
+TEST_CASE("Prefab instances serialize their overrides") {
+	auto const prefab = makePrefab();
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const root = scene.instantiate(prefab);
+	auto const entities = root.get<PrefabInstanceComponent>().entities;
+	
+	// An unmodified instance only writes its root.
+	YAML::Node node = scene.serialize();
+	REQUIRE(node.size() == 1);
+	CHECK(node[0]["ID"].as<EntityID::RawType>() == root.raw());
+	CHECK(node[0]["Prefab Instance"]["Entities"].size() == 4);
+	CHECK(!node[0]["Transform"].IsDefined());
+	
+	scene.getComponent<Transform>(entities[2]).position = { 5, 0, 0 };
+	scene.markTransformDirty(entities[2]);
+	scene.removeComponent<TagComponent>(entities[3]);
+	node = scene.serialize();
+	REQUIRE(node.size() == 3);
+	
+	auto const c = findNode(node, entities[2]);
+	REQUIRE(c.IsDefined());
+	CHECK(c.size() == 2);
+	CHECK(c["Transform"].IsDefined());
+	
+	auto const b = findNode(node, entities[3]);
+	REQUIRE(b.IsDefined());
+	REQUIRE(b["Removed Components"].size() == 1);
+	CHECK(b["Removed Components"][0].as<std::string>() == "Tag");
+}
+
+TEST_CASE("Prefab instances are serialized before other entities") {
+	auto const prefab = makePrefab();
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	scene.createEntity("Entity");
+	auto const root = scene.instantiate(prefab);
+	
+	// The streaming loader spawns an instance before it reads the overrides of its entities.
+	YAML::Node const node = scene.serialize();
+	REQUIRE(node.size() == 2);
+	CHECK(node[0]["ID"].as<EntityID::RawType>() == root.raw());
+	CHECK(node[1]["Tag"].IsDefined());
+}
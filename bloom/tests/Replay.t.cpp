@@ -0,0 +1,179 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Runtime/CoreRuntime.hpp"
+#include "Bloom/Runtime/Replay.hpp"
+#include "Bloom/Runtime/SceneSystem.hpp"
+
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace bloom;
+
+namespace {
+	struct Step {
+		double absolute, delta;
+		std::vector<Key> keys;
+		bool operator==(Step const&) const = default;
+	};
+	
+	struct StepRecorder: RuntimeDelegate {
+		void input(std::span<InputEvent const> events) override {
+			std::unique_lock lock(mutex);
+			keys.clear();
+			for (auto const& event: events) {
+				keys.push_back(event.get<KeyEvent>().key);
+			}
+		}
+		void step(Timestep t) override {
+			std::unique_lock lock(mutex);
+			steps.push_back({ t.absolute, t.delta, std::move(keys) });
+			keys.clear();
+		}
+		std::size_t stepCount() {
+			std::unique_lock lock(mutex);
+			return steps.size();
+		}
+		std::mutex mutex;
+		std::vector<Key> keys;
+		std::vector<Step> steps;
+	};
+	
+	InputEvent keyDown(Key key) {
+		KeyEvent event{};
+		event.key = key;
+		return InputEvent(InputEventType::keyDown, event);
+	}
+}
+
+TEST_CASE("Replay round trip", "[replay]") {
+	std::stringstream stream;
+	{
+		ReplayWriter writer(stream, { .stepsPerSecond = 60 });
+		writer.writeStep({ .absolute = 1, .delta = 1 }, {});
+		MouseDownEvent mouseDown{};
+		mouseDown.locationInWindow = { 3, 4 };
+		mouseDown.button = MouseButton::left;
+		mouseDown.clickCount = 2;
+		InputEvent const events[] = {
+			keyDown(Key::W),
+			InputEvent(InputEventType::leftMouseDown, mouseDown)
+		};
+		writer.writeStep({ .absolute = 2, .delta = 1 }, events);
+		CHECK(writer.stepCount() == 2);
+	}
+	
+	ReplayReader reader(stream);
+	CHECK(reader.header().stepsPerSecond == 60);
+	ReplayStep step;
+	REQUIRE(reader.next(step));
+	CHECK(step.timestep.absolute == 1);
+	CHECK(step.input.empty());
+	REQUIRE(reader.next(step));
+	CHECK(step.timestep.absolute == 2);
+	REQUIRE(step.input.size() == 2);
+	CHECK(step.input[0].type() == InputEventType::keyDown);
+	CHECK(step.input[0].get<KeyEvent>().key == Key::W);
+	CHECK(step.input[1].type() == InputEventType::leftMouseDown);
+	auto const& mouseDown = step.input[1].get<MouseDownEvent>();
+	CHECK(mouseDown.locationInWindow.x == 3);
+	CHECK(mouseDown.locationInWindow.y == 4);
+	CHECK(mouseDown.button == MouseButton::left);
+	CHECK(mouseDown.clickCount == 2);
+	CHECK(!reader.next(step));
+	CHECK(!reader.next(step));
+}
+
+TEST_CASE("Replay rejects invalid streams", "[replay]") {
+	std::stringstream empty;
+	CHECK_THROWS(ReplayReader(empty));
+	
+	std::stringstream garbage("not a replay at all");
+	CHECK_THROWS(ReplayReader(garbage));
+	
+	std::stringstream stream;
+	ReplayWriter(stream).writeStep({ .absolute = 1, .delta = 1 }, {});
+	std::string const truncated = stream.str().substr(0, stream.str().size() - 5);
+	std::stringstream truncatedStream(truncated);
+	ReplayReader reader(truncatedStream);
+	ReplayStep step;
+	CHECK_THROWS(reader.next(step));
+}
+
+TEST_CASE("Replay reproduces a recorded run", "[replay]") {
+	auto recorded = std::make_shared<StepRecorder>();
+	std::stringstream stream;
+	{
+		CoreRuntime runtime(recorded);
+		runtime.setUpdateOptions({ .stepsPerSecond = 1000 });
+		runtime.startRecording(stream);
+		CHECK(runtime.isRecording());
+		runtime.run();
+		for (Key key: { Key::A, Key::S, Key::D }) {
+			runtime.submitInput(keyDown(key));
+			auto const target = recorded->stepCount() + 2;
+			while (recorded->stepCount() < target) {
+				std::this_thread::yield();
+			}
+		}
+		runtime.stop();
+		runtime.stopRecording();
+	}
+	REQUIRE(recorded->steps.size() >= 6);
+	
+	StepRecorder replayed;
+	ReplayReader reader(stream);
+	CHECK(reader.header().stepsPerSecond == 1000);
+	auto const statistics = replay(reader, replayed);
+	CHECK(statistics.stepCount == recorded->steps.size());
+	CHECK(replayed.steps == recorded->steps);
+	
+	std::vector<Key> keys;
+	for (auto const& step: replayed.steps) {
+		keys.insert(keys.end(), step.keys.begin(), step.keys.end());
+	}
+	CHECK(keys == std::vector<Key>{ Key::A, Key::S, Key::D });
+}
+
+TEST_CASE("Replay feeds recorded input to scene systems", "[replay]") {
+	std::stringstream stream;
+	{
+		ReplayWriter writer(stream, { .stepsPerSecond = 50 });
+		std::vector<std::vector<Key>> const input = { {}, { Key::D }, { Key::D, Key::D }, {}, { Key::A } };
+		for (std::size_t i = 0; i < input.size(); ++i) {
+			std::vector<InputEvent> events;
+			for (Key key: input[i]) {
+				events.push_back(keyDown(key));
+			}
+			writer.writeStep({ .absolute = 0.02 * double(i + 1), .delta = 0.02 }, events);
+		}
+	}
+	
+	ThreadPool threadPool(0);
+	SceneSystem system(threadPool);
+	auto const scene = allocateRef<Scene>(AssetHandle::generate(AssetType::scene), "Test Scene");
+	EntityID const player = scene->createEntity("Player");
+	system.loadScene(scene);
+	
+	std::vector<float> positions;
+	system.systems().clear();
+	system.systems().add(SystemDescription("Player")
+		.writes<Transform>()
+		.run([&](Scene& scene, Timestep) {
+			auto& transform = scene.getComponent<Transform>(player);
+			for (auto const& event: system.stepInput()) {
+				if (event.type() == InputEventType::keyDown) {
+					transform.position.x += event.get<KeyEvent>().key == Key::D ? 1 : -1;
+				}
+			}
+			scene.markTransformDirty(player);
+			positions.push_back(transform.position.x);
+		}));
+	
+	ReplayReader reader(stream);
+	CHECK(replay(reader, system).stepCount == 5);
+	CHECK(positions == std::vector<float>{ 0, 1, 3, 3, 2 });
+	// Leaving play mode restores the scene.
+	CHECK(scene->getComponent<Transform>(player).position.x == 0);
+}
@@ -2,6 +2,11 @@
 
 #include "Bloom/Runtime/CoreRuntime.hpp"
 #include <utl/utility.hpp>
+#include <utl/vector.hpp>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
 
 using namespace bloom;
 
@@ -47,3 +52,132 @@ TEST_CASE("RuntimeSystem") {
 	utl::busy_wait([&]{ return del->value == 5; });
 	CHECK(del->value == 5);
 }
+
+namespace {
+	struct StepRecorder: RuntimeDelegate {
+		void step(Timestep timestep) override {
+			std::unique_lock lock(mutex);
+			timesteps.push_back(timestep);
+		}
+		std::size_t count() {
+			std::unique_lock lock(mutex);
+			return timesteps.size();
+		}
+		std::mutex mutex;
+		std::vector<Timestep> timesteps;
+	};
+}
+
+TEST_CASE("RuntimeSystem fixed timestep") {
+	auto del = std::make_shared<StepRecorder>();
+	CoreRuntime crt(del);
+	crt.setUpdateOptions({ .stepsPerSecond = 100 });
+	
+	crt.run();
+	utl::busy_wait([&]{ return del->count() >= 10; });
+	double const alpha = crt.interpolationAlpha();
+	CHECK(alpha >= 0);
+	CHECK(alpha <= 1);
+	crt.stop();
+	
+	REQUIRE(del->timesteps.size() >= 10);
+	for (std::size_t i = 0; i < del->timesteps.size(); ++i) {
+		CHECK(del->timesteps[i].delta == Approx(0.01));
+		CHECK(del->timesteps[i].absolute == Approx(0.01 * double(i + 1)));
+	}
+}
+
+namespace {
+	/// Counts violations of the delegate lifecycle. Catch assertions must not be used off the main thread.
+	struct LifecycleChecker: RuntimeDelegate {
+		void start() override {
+			violations += active.exchange(true);
+			++starts;
+		}
+		void stop() override {
+			violations += !active.exchange(false);
+			paused = false;
+			++stops;
+		}
+		void pause() override {
+			violations += !active || paused.exchange(true);
+		}
+		void resume() override {
+			violations += !active || !paused.exchange(false);
+		}
+		void step(Timestep) override {
+			violations += !active || paused;
+			++steps;
+		}
+		std::atomic_bool active = false, paused = false;
+		std::atomic_size_t starts = 0, stops = 0, steps = 0, violations = 0;
+	};
+	
+	/// Applies operation \p op to \p runtime. Returns the state the runtime must be in afterwards, given \p current.
+	RuntimeState applyOperation(CoreRuntime& runtime, int op, RuntimeState current) {
+		switch (op) {
+			case 0:
+				runtime.run();
+				return current == RuntimeState::inactive ? RuntimeState::running : current;
+			case 1:
+				runtime.pause();
+				return current == RuntimeState::running ? RuntimeState::paused : current;
+			case 2:
+				runtime.resume();
+				return current == RuntimeState::paused ? RuntimeState::running : current;
+			default:
+				runtime.stop();
+				return RuntimeState::inactive;
+		}
+	}
+}
+
+TEST_CASE("RuntimeSystem rapid state transitions") {
+	auto del = std::make_shared<LifecycleChecker>();
+	CoreRuntime crt(del);
+	crt.setUpdateOptions({ .stepsPerSecond = GENERATE(0, 1000) });
+	
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<int> operation(0, 3);
+	RuntimeState expected = RuntimeState::inactive;
+	for (int i = 0; i < 2000; ++i) {
+		expected = applyOperation(crt, operation(rng), expected);
+		REQUIRE(crt.state() == expected);
+	}
+	crt.stop();
+	
+	CHECK(del->violations == 0);
+	CHECK(del->starts == del->stops);
+	CHECK(!del->active);
+}
+
+TEST_CASE("RuntimeSystem concurrent state transitions") {
+	auto del = std::make_shared<LifecycleChecker>();
+	CoreRuntime crt(del);
+	crt.setUpdateOptions({ .stepsPerSecond = 0 });
+	crt.run();
+	
+	std::atomic_size_t alphaViolations = 0;
+	utl::vector<std::thread> threads;
+	for (unsigned seed = 0; seed < 4; ++seed) {
+		threads.emplace_back([&, seed]{
+			std::mt19937 rng(seed);
+			std::uniform_int_distribution<int> operation(0, 3);
+			for (int i = 0; i < 500; ++i) {
+				applyOperation(crt, operation(rng), RuntimeState::inactive);
+				crt.submitInput(InputEvent(InputEventType::mouseMoved, MouseMoveEvent{}));
+				double const alpha = crt.interpolationAlpha();
+				alphaViolations += alpha < 0 || alpha > 1;
+			}
+		});
+	}
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	crt.stop();
+	
+	CHECK(crt.state() == RuntimeState::inactive);
+	CHECK(alphaViolations == 0);
+	CHECK(del->violations == 0);
+	CHECK(del->starts == del->stops);
+}
@@ -0,0 +1,300 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Core/ThreadPool.hpp"
+#include "Bloom/Scene/Scene.hpp"
+
+#include <string>
+
+using namespace bloom;
+
+namespace {
+	void checkEqual(mtl::float4x4 const& a, mtl::float4x4 const& b) {
+		for (int c = 0; c < 4; ++c) {
+			for (int r = 0; r < 4; ++r) {
+				CHECK(a.column(c)[r] == Approx(b.column(c)[r]).margin(1e-5));
+			}
+		}
+	}
+}
+
+TEST_CASE("Scene incremental transform hierarchy") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const root = scene.createEntity("Root");
+	auto const child = scene.createEntity("Child");
+	auto const grandchild = scene.createEntity("Grandchild");
+	auto const other = scene.createEntity("Other");
+	scene.parent(child, root);
+	scene.parent(grandchild, child);
+	
+	scene.applyTransformHierarchy();
+	checkEqual(grandchild.get<TransformMatrixComponent>().matrix,
+			   scene.calculateTransformRelativeToWorld(grandchild));
+	
+	root.get<Transform>().position = { 1, 2, 3 };
+	scene.markTransformDirty(root);
+	other.get<Transform>().position = { 4, 5, 6 };
+	scene.applyTransformHierarchy();
+	
+	Scene reference = scene.copy();
+	reference.applyTransformHierarchy({ .incremental = false });
+	for (auto const entity: { root, child, grandchild }) {
+		checkEqual(entity.get<TransformMatrixComponent>().matrix,
+				   reference.getComponent<TransformMatrixComponent>(entity).matrix);
+	}
+	// 'other' was modified without being marked, so it must still hold its old matrix.
+	CHECK(other.get<TransformMatrixComponent>().matrix.column(3)[0] == Approx(0));
+}
+
+TEST_CASE("Scene packed transform hierarchy") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const a = scene.createEntity("A");
+	auto const b = scene.createEntity("B");
+	auto const c = scene.createEntity("C");
+	a.get<Transform>().position = { 1, 0, 0 };
+	b.get<Transform>().position = { 0, 1, 0 };
+	c.get<Transform>().position = { 0, 0, 1 };
+	// Create children before their parents to exercise sorting.
+	scene.parent(a, b);
+	scene.parent(b, c);
+	
+	for (bool const incremental: { false, true }) {
+		c.get<Transform>().position.x += 1;
+		scene.markTransformDirty(c);
+		scene.applyTransformHierarchy({ .incremental = incremental, .packed = true });
+		for (auto const entity: { a, b, c }) {
+			checkEqual(entity.get<TransformMatrixComponent>().matrix,
+					   scene.calculateTransformRelativeToWorld(entity));
+		}
+	}
+}
+
+TEST_CASE("Scene parallel transform hierarchy") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	utl::small_vector<EntityID> entities;
+	for (int i = 0; i < 64; ++i) {
+		auto const root = scene.createEntity("Root");
+		root.get<Transform>().position = { float(i), 0, 0 };
+		entities.push_back(root);
+		for (int j = 0; j < 8; ++j) {
+			auto const child = scene.createEntity("Child");
+			child.get<Transform>().position = { 0, float(j), 0 };
+			scene.parent(child, root);
+			entities.push_back(child);
+		}
+	}
+	
+	ThreadPool threadPool(4);
+	for (bool const incremental: { false, true }) {
+		for (std::size_t i = 0; i < entities.size(); i += 7) {
+			scene.getComponent<Transform>(entities[i]).position.z += 1;
+			scene.markTransformDirty(entities[i]);
+		}
+		scene.applyTransformHierarchy({
+			.incremental = incremental,
+			.threadPool = &threadPool,
+			.parallelThreshold = 0
+		});
+		
+		Scene reference = scene.copy();
+		reference.applyTransformHierarchy({ .incremental = false });
+		for (auto const entity: entities) {
+			checkEqual(scene.getComponent<TransformMatrixComponent>(entity).matrix,
+					   reference.getComponent<TransformMatrixComponent>(entity).matrix);
+		}
+	}
+}
+
+TEST_CASE("Scene cached world transform") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const root = scene.createEntity("Root");
+	auto const child = scene.createEntity("Child");
+	auto const grandchild = scene.createEntity("Grandchild");
+	scene.parent(child, root);
+	scene.parent(grandchild, child);
+	
+	// Rotations do not commute, so this also checks that parents are applied before children.
+	root.get<Transform>().orientation = mtl::normalize(mtl::quaternion_float(1, 0, 0, 1));
+	scene.markTransformDirty(root);
+	child.get<Transform>().position = { 1, 0, 0 };
+	child.get<Transform>().orientation = mtl::normalize(mtl::quaternion_float(1, 1, 0, 0));
+	scene.markTransformDirty(child);
+	grandchild.get<Transform>().position = { 0, 1, 0 };
+	scene.markTransformDirty(grandchild);
+	
+	scene.applyTransformHierarchy({ .incremental = false });
+	checkEqual(scene.calculateTransformRelativeToWorld(grandchild),
+			   grandchild.get<TransformMatrixComponent>().matrix);
+	// Served from the cache.
+	checkEqual(scene.calculateTransformRelativeToWorld(grandchild),
+			   grandchild.get<TransformMatrixComponent>().matrix);
+	
+	// Modifying an ancestor invalidates the cached descendants.
+	root.get<Transform>().position = { 0, 0, 5 };
+	scene.markTransformDirty(root);
+	scene.applyTransformHierarchy({ .incremental = false });
+	checkEqual(scene.calculateTransformRelativeToWorld(grandchild),
+			   grandchild.get<TransformMatrixComponent>().matrix);
+	
+	// So does changing the hierarchy.
+	scene.unparent(child);
+	scene.applyTransformHierarchy({ .incremental = false });
+	checkEqual(scene.calculateTransformRelativeToWorld(grandchild),
+			   grandchild.get<TransformMatrixComponent>().matrix);
+	
+	// Entries of other subtrees stay valid, changes below them still show up.
+	auto const other = scene.createEntity("Other");
+	other.get<Transform>().position = { 2, 0, 0 };
+	scene.markTransformDirty(other);
+	scene.calculateTransformRelativeToWorld(other);
+	scene.parent(child, other);
+	grandchild.get<Transform>().position = { 0, 3, 0 };
+	scene.markTransformDirty(grandchild);
+	scene.applyTransformHierarchy({ .incremental = false });
+	for (auto const entity: { other, child, grandchild }) {
+		checkEqual(scene.calculateTransformRelativeToWorld(entity),
+				   entity.get<TransformMatrixComponent>().matrix);
+	}
+	
+	// Changes not applied yet are computed on the fly.
+	mtl::float4x4 const before = scene.calculateTransformRelativeToWorld(grandchild);
+	other.get<Transform>().position = { 0, 0, 7 };
+	scene.markTransformDirty(other);
+	CHECK(scene.calculateTransformRelativeToWorld(grandchild).column(3)[2] == Approx(before.column(3)[2] + 7));
+	scene.applyTransformHierarchy();
+	checkEqual(scene.calculateTransformRelativeToWorld(grandchild),
+			   grandchild.get<TransformMatrixComponent>().matrix);
+}
+
+TEST_CASE("Scene bulk entity creation") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const single = scene.createEntity("Single");
+	auto const entities = scene.createEntities(100, "Bulk");
+	REQUIRE(entities.size() == 100);
+	for (auto const entity: entities) {
+		CHECK(scene.hasComponent<Transform>(entity));
+		CHECK(scene.hasComponent<TransformMatrixComponent>(entity));
+		CHECK(scene.hasComponent<HierarchyComponent>(entity));
+		CHECK(scene.getComponent<TagComponent>(entity).name == "Bulk");
+	}
+	
+	scene.destroyEntities(entities);
+	CHECK(scene.view<Transform>().size() == 1);
+	CHECK(scene.hasComponent<Transform>(single));
+}
+
+TEST_CASE("Scene name lookup") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const a = scene.createEntity("Lamp");
+	auto const b = scene.createEntity("Lamp");
+	auto const c = scene.createEntity("Table");
+	
+	CHECK(scene.getComponent<TagComponent>(a).name == scene.getComponent<TagComponent>(b).name);
+	CHECK(scene.findEntities("Lamp").size() == 2);
+	CHECK(scene.findEntity("Table") == c);
+	CHECK(!scene.findEntity("Name that was never used"));
+	
+	scene.setName(b, "Chair");
+	CHECK(scene.findEntities("Lamp").size() == 1);
+	CHECK(scene.findEntity("Chair") == b);
+	
+	scene.deleteEntity(a);
+	CHECK(!scene.findEntity("Lamp"));
+	
+	Scene copy = scene.copy();
+	CHECK(copy.findEntity("Chair") == b);
+}
+
+TEST_CASE("Scene names live in the scene") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const entity = scene.createEntity("Name");
+	// Like typing a new name into the inspector.
+	for (int i = 0; i < 1000; ++i) {
+		scene.setName(entity, "Name " + std::to_string(i));
+	}
+	CHECK(scene.findEntity("Name 999") == entity);
+	CHECK(!scene.findEntity("Name 998"));
+	
+	// Tags created outside the scene, like deserialized ones, are moved into its table.
+	auto const other = scene.createEmptyEntity();
+	other.add(TagComponent{ "Name 999" });
+	CHECK(other.get<TagComponent>().name.c_str() == entity.get<TagComponent>().name.c_str());
+	CHECK(scene.findEntities("Name 999").size() == 2);
+}
+
+TEST_CASE("Scene copy") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const root = scene.createEntity("Root");
+	auto const deleted = scene.createEntity("Deleted");
+	auto const child = scene.createEntity("Child");
+	scene.parent(child, root);
+	scene.deleteEntity(deleted);
+	root.get<Transform>().position = { 1, 2, 3 };
+	scene.markTransformDirty(root);
+	
+	Scene backup = scene.copy();
+	CHECK(backup.getComponent<Transform>(root).position.y == 2);
+	CHECK(backup.getComponent<HierarchyComponent>(child).parent == root);
+	CHECK(backup.findEntity("Child") == child);
+	
+	// Modify the scene, then restore it from the backup.
+	root.get<Transform>().position.y = 10;
+	scene.deleteEntity(child);
+	scene.createEntity("Added");
+	scene = std::move(backup);
+	CHECK(root.get<Transform>().position.y == 2);
+	CHECK(scene.hasComponent<Transform>(child));
+	CHECK(scene.getComponent<TagComponent>(child).name == "Child");
+	CHECK(!scene.findEntity("Added"));
+	
+	// Identifiers are recycled just like in the original scene.
+	Scene other = scene.copy();
+	CHECK(scene.createEmptyEntity() == other.createEmptyEntity());
+}
+
+TEST_CASE("Scene clone subtree") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const parent = scene.createEntity("Parent");
+	auto const root = scene.createEntity("Root");
+	auto const a = scene.createEntity("A");
+	auto const b = scene.createEntity("B");
+	auto const c = scene.createEntity("C");
+	scene.parent(root, parent);
+	scene.parent(a, root);
+	scene.parent(b, root);
+	scene.parent(c, a);
+	parent.get<Transform>().position = { 1, 0, 0 };
+	root.get<Transform>().orientation = mtl::normalize(mtl::quaternion_float(1, 0, 0, 1));
+	a.get<Transform>().position = { 0, 2, 0 };
+	c.get<Transform>().position = { 0, 0, 3 };
+	for (auto const entity: { parent, root, a, c }) {
+		scene.markTransformDirty(entity);
+	}
+	
+	auto const clone = scene.cloneSubtree(root);
+	scene.applyTransformHierarchy();
+	
+	CHECK(scene.getComponent<HierarchyComponent>(clone).parent == parent);
+	checkEqual(clone.get<TransformMatrixComponent>().matrix, root.get<TransformMatrixComponent>().matrix);
+	
+	utl::small_vector<EntityID> children;
+	for (auto const child: scene.children(clone)) {
+		children.push_back(child);
+	}
+	REQUIRE(children.size() == 2);
+	CHECK(children[0] != a);
+	CHECK(scene.getComponent<TagComponent>(children[0]).name == "A");
+	CHECK(scene.getComponent<TagComponent>(children[1]).name == "B");
+	CHECK(scene.getComponent<HierarchyComponent>(children[0]).parent == clone);
+	
+	auto const grandchild = scene.getComponent<HierarchyComponent>(children[0]).firstChild;
+	REQUIRE(grandchild);
+	CHECK(grandchild != c);
+	CHECK(scene.getComponent<TagComponent>(grandchild).name == "C");
+	checkEqual(scene.getComponent<TransformMatrixComponent>(grandchild).matrix,
+			   c.get<TransformMatrixComponent>().matrix);
+	
+	// The original is left untouched.
+	CHECK(scene.getComponent<HierarchyComponent>(root).firstChild == a);
+	CHECK(scene.getComponent<HierarchyComponent>(a).nextSibling == b);
+	CHECK(scene.findEntities("C").size() == 2);
+}
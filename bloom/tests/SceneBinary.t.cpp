@@ -0,0 +1,113 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Asset/AssetManager.hpp"
+#include "Bloom/Scene/Scene.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace bloom;
+
+TEST_CASE("Binary scene round trip") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Source");
+	auto const root = scene.createEntity("Root");
+	auto const child = scene.createEntity("Child");
+	auto const removed = scene.createEntity("Removed");
+	scene.parent(child, root);
+	child.get<Transform>().position = { 0, 2, 0 };
+	scene.markTransformDirty(child);
+	root.add(PointLightComponent{});
+	root.get<PointLightComponent>().light.radius = 5;
+	scene.deleteEntity(removed);
+	
+	std::stringstream stream;
+	scene.serializeBinary(stream);
+	AssetManager assetManager;
+	Scene loaded(scene.handle(), "Loaded");
+	loaded.deserializeBinary(stream, assetManager);
+	
+	REQUIRE(loaded.isValid(root));
+	REQUIRE(loaded.isValid(child));
+	CHECK(!loaded.isValid(removed));
+	CHECK(loaded.getComponent<TagComponent>(child).name == "Child");
+	CHECK(loaded.getComponent<HierarchyComponent>(child).parent == root);
+	CHECK(loaded.getComponent<HierarchyComponent>(root).firstChild == child);
+	CHECK(loaded.getComponent<PointLightComponent>(root).light.radius == 5);
+	CHECK(!loaded.hasComponent<PointLightComponent>(child));
+	
+	loaded.applyTransformHierarchy();
+	CHECK(loaded.getComponent<TransformMatrixComponent>(child).matrix.column(3)[1] == Approx(2));
+	
+	// Released identifiers are restored, so both scenes hand out the same identifier next.
+	EntityID const next = loaded.createEntity("Next");
+	EntityID const expected = scene.createEntity("Next");
+	CHECK(next == expected);
+}
+
+TEST_CASE("Binary scene rejects invalid streams") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Source");
+	scene.createEntity("Entity");
+	std::stringstream stream;
+	scene.serializeBinary(stream);
+	AssetManager assetManager;
+	
+	std::string truncated = stream.str();
+	truncated.resize(truncated.size() - 3);
+	std::stringstream truncatedStream(truncated);
+	Scene a(scene.handle(), "Truncated");
+	CHECK_THROWS_AS(a.deserializeBinary(truncatedStream, assetManager), std::runtime_error);
+	
+	std::stringstream garbage("not a scene");
+	Scene b(scene.handle(), "Garbage");
+	CHECK_THROWS_AS(b.deserializeBinary(garbage, assetManager), std::runtime_error);
+}
+
+TEST_CASE("Binary scene rejects corrupted component blocks") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Source");
+	scene.createEntity("A").add(PointLightComponent{});
+	scene.createEntity("B").add(PointLightComponent{});
+	std::stringstream stream;
+	scene.serializeBinary(stream);
+	std::string const bytes = stream.str();
+	AssetManager assetManager;
+	
+	// A block starts with its byte size, followed by the component count and the entities.
+	auto const blockAt = [&](std::string_view name) {
+		auto const pos = bytes.find(name);
+		REQUIRE(pos != std::string::npos);
+		return pos + name.size();
+	};
+	auto const rejects = [&](std::string const& corrupted) {
+		std::stringstream corruptedStream(corrupted);
+		Scene loaded(scene.handle(), "Corrupted");
+		CHECK_THROWS_AS(loaded.deserializeBinary(corruptedStream, assetManager), std::runtime_error);
+	};
+	
+	SECTION("Duplicate entity") {
+		std::string corrupted = bytes;
+		std::size_t const entities = blockAt("Point Light") + 2 * sizeof(std::uint64_t);
+		corrupted.replace(entities + sizeof(entt::entity), sizeof(entt::entity), bytes, entities, sizeof(entt::entity));
+		rejects(corrupted);
+	}
+	
+	SECTION("Raw block size") {
+		std::string corrupted = bytes;
+		++corrupted[blockAt("Point Light")];
+		rejects(corrupted);
+	}
+	
+	SECTION("Encoded block size") {
+		std::string corrupted = bytes;
+		++corrupted[blockAt("Tag")];
+		rejects(corrupted);
+	}
+}
+
+TEST_CASE("Binary scene stores names, not pointers") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Source");
+	scene.createEntity("A name that only the saved bytes can hold");
+	std::stringstream stream;
+	scene.serializeBinary(stream);
+	CHECK(stream.str().find("A name that only the saved bytes can hold") != std::string::npos);
+}
@@ -0,0 +1,170 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Runtime/SceneSystem.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace bloom;
+
+namespace {
+	/// Reader that creates a scene with one entity per read. Blocks while \p closed is set.
+	struct TestReader {
+		std::atomic_bool closed = false;
+		std::atomic_bool entered = false;
+		std::atomic_size_t readCount = 0;
+		std::mutex mutex;
+		utl::vector<utl::UUID> order;
+		
+		SceneSystem::SceneReader function() {
+			return [this](AssetHandle handle) -> std::optional<Scene> {
+				entered = true;
+				while (closed) {
+					std::this_thread::yield();
+				}
+				{
+					std::unique_lock lock(mutex);
+					order.push_back(handle.id());
+				}
+				Scene scene(handle, "Streamed");
+				scene.createEntity("Entity");
+				++readCount;
+				return scene;
+			};
+		}
+	};
+	
+	Reference<Scene> makeTarget() {
+		return allocateRef<Scene>(AssetHandle::generate(AssetType::scene), "Target");
+	}
+	
+	void updateUntilIdle(SceneSystem& system) {
+		while (system.pendingStreamCount() > 0) {
+			system.update();
+			std::this_thread::yield();
+		}
+	}
+}
+
+TEST_CASE("SceneSystem streams scenes in at update") {
+	ThreadPool threadPool(2);
+	SceneSystem system(threadPool);
+	TestReader reader;
+	system.setSceneReader(reader.function());
+	
+	auto const target = makeTarget();
+	system.streamScene(target);
+	CHECK(system.scenes().empty());
+	updateUntilIdle(system);
+	
+	REQUIRE(system.scenes().size() == 1);
+	CHECK(system.scenes()[0] == target.get());
+	CHECK(!target->empty());
+	
+	system.streamOutScene(target->handle().id());
+	CHECK(system.scenes().size() == 1);
+	system.update();
+	CHECK(system.scenes().empty());
+}
+
+TEST_CASE("SceneSystem starts streams by priority") {
+	ThreadPool threadPool(2);
+	SceneSystem system(threadPool);
+	TestReader reader;
+	reader.closed = true;
+	system.setSceneReader(reader.function());
+	
+	auto const a = makeTarget(), b = makeTarget(), c = makeTarget(), d = makeTarget();
+	system.streamScene(a, 0); // Starts right away and blocks the only slot.
+	system.streamScene(b, 1);
+	system.streamScene(c, 5);
+	auto const dID = system.streamScene(d, 3);
+	CHECK(system.pendingStreamCount() == 4);
+	
+	CHECK(system.cancelStream(dID));
+	CHECK(!system.cancelStream(dID));
+	CHECK(system.pendingStreamCount() == 3);
+	
+	reader.closed = false;
+	updateUntilIdle(system);
+	
+	REQUIRE(reader.order.size() == 3);
+	CHECK(reader.order[0] == a->handle().id());
+	CHECK(reader.order[1] == c->handle().id());
+	CHECK(reader.order[2] == b->handle().id());
+	CHECK(system.scenes().size() == 3);
+	CHECK(d->empty());
+}
+
+TEST_CASE("SceneSystem drops streams cancelled while reading") {
+	ThreadPool threadPool(2);
+	SceneSystem system(threadPool);
+	TestReader reader;
+	reader.closed = true;
+	system.setSceneReader(reader.function());
+	
+	auto const target = makeTarget();
+	auto const id = system.streamScene(target);
+	while (!reader.entered) {
+		std::this_thread::yield();
+	}
+	CHECK(system.cancelStream(id));
+	CHECK(system.pendingStreamCount() == 0);
+	
+	reader.closed = false;
+	while (reader.readCount == 0) {
+		system.update();
+		std::this_thread::yield();
+	}
+	system.update();
+	CHECK(system.scenes().empty());
+	CHECK(target->empty());
+}
+
+TEST_CASE("SceneSystem restores only the scenes still loaded when the simulation stops") {
+	ThreadPool threadPool(2);
+	SceneSystem system(threadPool);
+	RuntimeDelegate& delegate = system;
+	TestReader reader;
+	system.setSceneReader(reader.function());
+	
+	auto const a = makeTarget(), b = makeTarget();
+	system.streamScene(a);
+	updateUntilIdle(system);
+	
+	delegate.start();
+	system.streamScene(b);
+	updateUntilIdle(system);
+	delegate.step(Timestep{ .absolute = 0.1, .delta = 0.1 });
+	for (auto&& [id, transform]: b->view<Transform>().each()) {
+		CHECK(transform.position.x != 0);
+	}
+	system.streamOutScene(a->handle().id());
+	system.update();
+	delegate.step(Timestep{ .absolute = 0.2, .delta = 0.1 });
+	delegate.stop();
+	
+	REQUIRE(system.scenes().size() == 1);
+	CHECK(system.scenes()[0] == b.get());
+	CHECK(!b->empty());
+	for (auto&& [id, transform]: b->view<Transform>().each()) {
+		CHECK(transform.position.x == 0);
+	}
+}
+
+TEST_CASE("SceneSystem finishes stream reads before replacing its thread pool") {
+	ThreadPool threadPool(0);
+	SceneSystem system(threadPool);
+	TestReader reader;
+	system.setSceneReader(reader.function());
+	
+	auto const target = makeTarget();
+	system.streamScene(target);
+	system.setTransformWorkerCount(1);
+	CHECK(reader.readCount == 1);
+	
+	system.update();
+	REQUIRE(system.scenes().size() == 1);
+	CHECK(system.scenes()[0] == target.get());
+}
@@ -0,0 +1,115 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Scene/SpatialIndex.hpp"
+
+#include <algorithm>
+#include <random>
+#include <utl/vector.hpp>
+
+using namespace bloom;
+
+namespace {
+	AABB makeBox(mtl::float3 center, float size) {
+		return { center - size, center + size };
+	}
+	
+	/// Reference results by testing every box.
+	template <typename Volume>
+	utl::vector<EntityID::RawType> bruteForce(utl::vector<AABB> const& boxes, utl::vector<bool> const& alive, Volume const& volume) {
+		utl::vector<EntityID::RawType> result;
+		for (std::size_t i = 0; i < boxes.size(); ++i) {
+			if (alive[i] && intersects(boxes[i], volume)) {
+				result.push_back(EntityID::RawType(i));
+			}
+		}
+		return result;
+	}
+	
+	template <typename Volume>
+	utl::vector<EntityID::RawType> query(SpatialIndex const& index, Volume const& volume) {
+		utl::vector<EntityID::RawType> result;
+		index.query(volume, [&](EntityID entity) { result.push_back(entity.raw()); });
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+}
+
+TEST_CASE("SpatialIndex matches brute force") {
+	std::mt19937 rng(0);
+	std::uniform_real_distribution<float> position(-50, 50);
+	auto randomPoint = [&]{ return mtl::float3(position(rng), position(rng), position(rng)); };
+	
+	SpatialIndex index;
+	utl::vector<AABB> boxes;
+	utl::vector<bool> alive;
+	utl::vector<SpatialIndex::ProxyID> proxies;
+	for (int i = 0; i < 1000; ++i) {
+		boxes.push_back(makeBox(randomPoint(), 1));
+		alive.push_back(true);
+		proxies.push_back(index.insert(boxes.back(), EntityID(EntityID::RawType(i))));
+	}
+	// Move some boxes a little and some far, remove others.
+	for (std::size_t i = 0; i < boxes.size(); ++i) {
+		if (i % 7 == 0) {
+			index.remove(proxies[i]);
+			alive[i] = false;
+		}
+		else if (i % 3 == 0) {
+			boxes[i] = makeBox(i % 2 ? boxes[i].center() + 0.05f : randomPoint(), 1);
+			index.update(proxies[i], boxes[i]);
+		}
+	}
+	REQUIRE(index.size() == std::size_t(std::count(alive.begin(), alive.end(), true)));
+	// A balanced tree over ~850 leaves.
+	CHECK(index.height() < 20);
+	
+	for (int q = 0; q < 20; ++q) {
+		auto const center = randomPoint();
+		AABB const box = makeBox(center, 10);
+		CHECK(query(index, box) == bruteForce(boxes, alive, box));
+		Sphere const sphere = { center, 12 };
+		CHECK(query(index, sphere) == bruteForce(boxes, alive, sphere));
+	}
+	
+	SECTION("Frustum") {
+		// Orthographic projection of the cube [-20, 20]^3.
+		float const s = 1.0f / 20;
+		Frustum const frustum(mtl::float4x4{
+			s, 0, 0, 0,
+			0, s, 0, 0,
+			0, 0, s, 0,
+			0, 0, 0, 1
+		});
+		CHECK(frustum.planes().size() == 6);
+		CHECK(query(index, frustum) == bruteForce(boxes, alive, makeBox(mtl::float3(0), 20)));
+	}
+	
+	SECTION("Raycast") {
+		Ray const ray = { .origin = { -100, 0, 0 }, .direction = { 1, 0, 0 } };
+		float nearest = std::numeric_limits<float>::max();
+		for (std::size_t i = 0; i < boxes.size(); ++i) {
+			if (auto const distance = alive[i] ? intersect(ray, boxes[i], nearest) : std::nullopt) {
+				nearest = *distance;
+			}
+		}
+		auto const hit = index.raycast(ray);
+		REQUIRE(hit.has_value() == (nearest < std::numeric_limits<float>::max()));
+		if (hit) {
+			CHECK(hit->distance == Approx(nearest));
+		}
+	}
+}
+
+TEST_CASE("SpatialIndex keeps fat bounds for small moves") {
+	SpatialIndex index(0.5f);
+	auto const proxy = index.insert(makeBox(mtl::float3(0), 1), EntityID(EntityID::RawType(0)));
+	index.insert(makeBox(mtl::float3(10), 1), EntityID(EntityID::RawType(1)));
+	
+	CHECK(!index.update(proxy, makeBox({ 0.2f, 0, 0 }, 1)));
+	CHECK(index.bounds(proxy).lower.x == Approx(-0.8f));
+	CHECK(index.update(proxy, makeBox({ 5, 0, 0 }, 1)));
+	
+	index.remove(proxy);
+	CHECK(index.size() == 1);
+	CHECK(query(index, makeBox(mtl::float3(0), 2)).empty());
+}
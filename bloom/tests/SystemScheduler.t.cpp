@@ -0,0 +1,135 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Core/ThreadPool.hpp"
+#include "Bloom/Runtime/SystemScheduler.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using namespace bloom;
+
+namespace {
+	struct Velocity {
+		mtl::float3 value = 0;
+	};
+	struct Health {
+		float value = 100;
+	};
+}
+
+TEST_CASE("SystemScheduler conflicts", "[system-scheduler]") {
+	auto system = [](char const* name) {
+		return SystemDescription(name).run([](Scene&, Timestep) {});
+	};
+	auto const readsTransform = system("A").reads<Transform>();
+	auto const alsoReadsTransform = system("B").reads<Transform>();
+	auto const writesTransform = system("C").writes<Transform>();
+	auto const writesHealth = system("D").writes<Health>();
+	auto const exclusive = system("E").exclusive();
+	
+	CHECK(!readsTransform.conflictsWith(alsoReadsTransform));
+	CHECK(readsTransform.conflictsWith(writesTransform));
+	CHECK(writesTransform.conflictsWith(readsTransform));
+	CHECK(writesTransform.conflictsWith(writesTransform));
+	CHECK(!writesTransform.conflictsWith(writesHealth));
+	CHECK(exclusive.conflictsWith(writesHealth));
+	CHECK(exclusive.conflictsWith(system("F")));
+}
+
+TEST_CASE("SystemScheduler conflicts through scene signals", "[system-scheduler]") {
+	auto system = [](char const* name) {
+		return SystemDescription(name).run([](Scene&, Timestep) {});
+	};
+	// Writing transforms and names both update state the scene keeps alongside the components.
+	auto const writesTransform = system("A").writes<Transform>();
+	auto const writesTag = system("B").writes<TagComponent>();
+	auto const readsHierarchy = system("C").reads<HierarchyComponent>();
+	auto const readsMeshRenderer = system("D").reads<MeshRendererComponent>();
+	auto const readsDirtyTag = system("E").reads<TransformDirtyTag>();
+	
+	CHECK(writesTransform.conflictsWith(writesTag));
+	CHECK(writesTag.conflictsWith(readsHierarchy));
+	CHECK(writesTransform.conflictsWith(readsDirtyTag));
+	CHECK(!readsHierarchy.conflictsWith(readsMeshRenderer));
+	CHECK(!writesTag.conflictsWith(readsDirtyTag));
+}
+
+TEST_CASE("SystemScheduler dependencies", "[system-scheduler]") {
+	SystemScheduler scheduler;
+	auto const noop = [](Scene&, Timestep) {};
+	auto const movement = scheduler.add(SystemDescription("Movement")
+		.reads<Velocity>().writes<Transform, TransformDirtyTag>().run(noop));
+	auto const damage = scheduler.add(SystemDescription("Damage")
+		.writes<Health>().run(noop));
+	auto const camera = scheduler.add(SystemDescription("Camera")
+		.reads<Transform>().run(noop));
+	auto const spawn = scheduler.add(SystemDescription("Spawn")
+		.exclusive().run(noop));
+	
+	using Edge = std::pair<SystemScheduler::SystemID, SystemScheduler::SystemID>;
+	auto const dependencies = scheduler.dependencies();
+	std::vector<Edge> const edges(dependencies.begin(), dependencies.end());
+	CHECK(edges == std::vector<Edge>{
+		{ movement, camera },
+		{ movement, spawn },
+		{ damage, spawn },
+		{ camera, spawn }
+	});
+}
+
+TEST_CASE("SystemScheduler run", "[system-scheduler]") {
+	std::size_t const workerCount = GENERATE(0, 4);
+	ThreadPool threadPool(workerCount);
+	
+	Scene scene(AssetHandle::generate(AssetType::scene), "Test Scene");
+	auto const entities = scene.createEntities(1000, "Entity");
+	for (auto entity: entities) {
+		scene.addComponent(entity, Velocity{ { 1, 0, 0 } });
+		scene.addComponent(entity, Health{});
+	}
+	
+	std::mutex mutex;
+	std::vector<std::string_view> order;
+	auto record = [&](std::string_view name) {
+		std::unique_lock lock(mutex);
+		order.push_back(name);
+	};
+	
+	SystemScheduler scheduler;
+	scheduler.add(SystemDescription("Movement")
+		.reads<Velocity>()
+		.writes<Transform, TransformDirtyTag>()
+		.run([&](Scene& scene, Timestep) {
+			record("Movement");
+			for (auto&& [id, velocity, transform]: scene.view<Velocity const, Transform>().each()) {
+				transform.position += velocity.value;
+				scene.markTransformDirty(id);
+			}
+		}));
+	scheduler.add(SystemDescription("Damage")
+		.writes<Health>()
+		.run([&](Scene& scene, Timestep) {
+			record("Damage");
+			for (auto&& [id, health]: scene.view<Health>().each()) {
+				health.value -= 1;
+			}
+		}));
+	scheduler.add(SystemDescription("Check")
+		.reads<Transform, Health>()
+		.run([&](Scene& scene, Timestep) {
+			record("Check");
+		}));
+	
+	Scene* const scenes[] = { &scene };
+	for (int step = 1; step <= 3; ++step) {
+		order.clear();
+		scheduler.run(scenes, {}, workerCount ? &threadPool : nullptr);
+		REQUIRE(order.size() == 3);
+		CHECK(order.back() == "Check");
+		for (auto entity: entities) {
+			CHECK(scene.getComponent<Transform>(entity).position.x == step);
+			CHECK(scene.getComponent<Health>(entity).value == 100 - step);
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Scene/Components/Transform.hpp"
+#include "Bloom/Scene/TransformKernels.hpp"
+
+#include <utl/vector.hpp>
+
+using namespace bloom;
+
+namespace {
+	void checkEqual(mtl::float4x4 const& a, mtl::float4x4 const& b) {
+		for (int c = 0; c < 4; ++c) {
+			for (int r = 0; r < 4; ++r) {
+				CHECK(a.column(c)[r] == Approx(b.column(c)[r]).margin(1e-5));
+			}
+		}
+	}
+	
+	utl::vector<Transform> makeTransforms(std::size_t count) {
+		utl::vector<Transform> result;
+		for (std::size_t i = 0; i < count; ++i) {
+			float const f = float(i);
+			result.push_back({
+				.position = { f, -2 * f, 0.5f * f },
+				.orientation = mtl::normalize(mtl::quaternion_float(1, 0.1f * f, -0.3f, 0.2f * f)),
+				.scale = { 1 + f, 2, 0.5f }
+			});
+		}
+		return result;
+	}
+}
+
+TEST_CASE("Batch transform kernels") {
+	auto const path = GENERATE(SIMDPath::scalar, SIMDPath::sse, SIMDPath::avx2);
+	if (path > bestSIMDPath()) {
+		return;
+	}
+	INFO(toString(path));
+	
+	// Odd count to exercise partial blocks.
+	auto const transforms = makeTransforms(13);
+	utl::vector<mtl::float4x4> matrices(transforms.size());
+	
+	calculateTransforms(transforms.data(), matrices.data(), transforms.size(), path);
+	for (std::size_t i = 0; i < transforms.size(); ++i) {
+		checkEqual(matrices[i], transforms[i].calculate());
+	}
+	
+	auto const parent = transforms[3].calculate();
+	utl::vector<mtl::float4x4> products(matrices.size());
+	multiplyMatrices(parent, matrices.data(), products.data(), matrices.size(), path);
+	for (std::size_t i = 0; i < matrices.size(); ++i) {
+		checkEqual(products[i], parent * matrices[i]);
+	}
+	
+	utl::vector<mtl::float4x4> transposed(matrices.size());
+	transposeMatrices(matrices.data(), transposed.data(), matrices.size(), path);
+	for (std::size_t i = 0; i < matrices.size(); ++i) {
+		checkEqual(transposed[i], mtl::transpose(matrices[i]));
+	}
+}
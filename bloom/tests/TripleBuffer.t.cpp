@@ -0,0 +1,65 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Core/TripleBuffer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <thread>
+
+using namespace bloom;
+
+namespace {
+	struct Payload {
+		std::size_t sequence = 0;
+		std::array<std::size_t, 64> values{};
+	};
+}
+
+TEST_CASE("TripleBuffer single thread") {
+	TripleBuffer<int> buffer;
+	CHECK(!buffer.hasNewValue());
+	CHECK(buffer.consume() == 0);
+	
+	buffer.back() = 1;
+	buffer.publish();
+	CHECK(buffer.hasNewValue());
+	CHECK(buffer.consume() == 1);
+	CHECK(!buffer.hasNewValue());
+	CHECK(buffer.consume() == 1);
+	
+	buffer.back() = 2;
+	buffer.publish();
+	buffer.back() = 3;
+	buffer.publish();
+	CHECK(buffer.consume() == 3);
+}
+
+TEST_CASE("TripleBuffer producer/consumer") {
+	std::size_t const count = 100'000;
+	TripleBuffer<Payload> buffer;
+	
+	std::thread producer([&]{
+		for (std::size_t i = 1; i <= count; ++i) {
+			Payload& payload = buffer.back();
+			payload.sequence = i;
+			payload.values.fill(i);
+			buffer.publish();
+		}
+	});
+	
+	std::size_t last = 0;
+	bool consistent = true, monotonic = true;
+	while (last < count) {
+		Payload const& payload = buffer.consume();
+		for (std::size_t value: payload.values) {
+			consistent &= value == payload.sequence;
+		}
+		monotonic &= payload.sequence >= last;
+		last = payload.sequence;
+	}
+	producer.join();
+	
+	CHECK(consistent);
+	CHECK(monotonic);
+	CHECK(buffer.consume().sequence == count);
+}
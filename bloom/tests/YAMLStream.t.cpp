@@ -0,0 +1,86 @@
+#include <Catch2/Catch2.hpp>
+
+#include "Bloom/Asset/AssetManager.hpp"
+#include "Bloom/Core/YAMLStream.hpp"
+#include "Bloom/Scene/Scene.hpp"
+
+#include <utl/vector.hpp>
+#include <sstream>
+#include <string>
+
+using namespace bloom;
+
+namespace {
+	utl::vector<YAML::Node> readElements(std::string const& text, bool* foundSequence = nullptr) {
+		std::istringstream stream(text);
+		utl::vector<YAML::Node> result;
+		bool const found = forEachSequenceElement(stream, [&](YAML::Node const& node) {
+			result.push_back(node);
+		});
+		if (foundSequence) {
+			*foundSequence = found;
+		}
+		return result;
+	}
+}
+
+TEST_CASE("forEachSequenceElement builds the same nodes as YAML::Load") {
+	std::string const text =
+		"- ID: 1\n"
+		"  Tag: {name: Root}\n"
+		"  Hierarchy: {parent: ~, children: [2, 3]}\n"
+		"- ID: 2\n"
+		"  Transform: &transform\n"
+		"    position: [0, 2, 0]\n"
+		"- ID: 3\n"
+		"  Transform: *transform\n"
+		"- 4\n";
+	auto const elements = readElements(text);
+	YAML::Node const reference = YAML::Load(text);
+	REQUIRE(elements.size() == reference.size());
+	for (std::size_t i = 0; i < elements.size(); ++i) {
+		CHECK(YAML::Dump(elements[i]) == YAML::Dump(reference[i]));
+	}
+	CHECK(elements[0]["Hierarchy"]["parent"].IsNull());
+	CHECK(elements[2]["Transform"]["position"][1].as<int>() == 2);
+}
+
+TEST_CASE("forEachSequenceElement handles documents without a sequence") {
+	bool foundSequence = true;
+	CHECK(readElements("", &foundSequence).empty());
+	CHECK(!foundSequence);
+	
+	CHECK(readElements("[]", &foundSequence).empty());
+	CHECK(foundSequence);
+	
+	CHECK_THROWS_AS(readElements("Key: Value"), YAML::Exception);
+}
+
+TEST_CASE("Scene streams the text format") {
+	Scene scene(AssetHandle::generate(AssetType::scene), "Source");
+	auto const root = scene.createEntity("Root");
+	auto const child = scene.createEntity("Child");
+	scene.parent(child, root);
+	child.get<Transform>().position = { 0, 2, 0 };
+	scene.markTransformDirty(child);
+	
+	std::stringstream stream;
+	stream << scene.serialize();
+	AssetManager assetManager;
+	Scene loaded(scene.handle(), "Loaded");
+	REQUIRE(loaded.deserialize(stream, assetManager));
+	
+	REQUIRE(loaded.isValid(root));
+	REQUIRE(loaded.isValid(child));
+	CHECK(loaded.getComponent<TagComponent>(child).name == "Child");
+	CHECK(loaded.getComponent<HierarchyComponent>(child).parent == root);
+	CHECK(loaded.getComponent<Transform>(child).position[1] == Approx(2));
+}
+
+TEST_CASE("Scene streaming reports identifiers it can't resolve") {
+	// Two versions of the same index can only be told apart with the whole document.
+	std::stringstream stream("- ID: 1\n- ID: 1048577\n");
+	AssetManager assetManager;
+	Scene scene(AssetHandle::generate(AssetType::scene), "Conflict");
+	CHECK(!scene.deserialize(stream, assetManager));
+}
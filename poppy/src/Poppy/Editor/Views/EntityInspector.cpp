@@ -72,8 +72,7 @@ namespace poppy {
 	
 	void EntityInspector::inspectTag(bloom::EntityHandle entity) {
 		using namespace bloom;
-		auto& tag = entity.get<TagComponent>();
-		std::string_view const name = tag.name;
+		std::string_view const name = entity.get<TagComponent>().name;
 		
 		float2 const framePadding = GImGui->Style.FramePadding;
 		ImGui::BeginChild("##inspect-tag-child", { 0, GImGui->FontSize + 2 * framePadding.y });
@@ -93,7 +92,7 @@ namespace poppy {
 				ImGui::SetNextItemWidth(nameTextSize.x);
 				if (editingNameState > 1) { ImGui::SetKeyboardFocusHere(); }
 				if (ImGui::InputText("##name-input", buffer, 256)) {
-					tag.name = buffer;
+					entity.scene().setName(entity, buffer);
 				}
 				editingNameState = ImGui::IsWindowFocused();
 			}
@@ -166,7 +165,9 @@ namespace poppy {
 				float const width = ImGui::GetContentRegionAvail().x - lockButtonSize.x - style.ItemSpacing.x;
 				
 				ImGui::SetNextItemWidth(width);
-				dragFloat3Pretty("##position", transform.position.data());
+				if (dragFloat3Pretty("##position", transform.position.data())) {
+					entity.scene().markTransformDirty(entity);
+				}
 				if (ImGui::IsItemClicked()) {
 					window().setCursorMode(CursorMode::disabled);
 				}
@@ -179,22 +180,26 @@ namespace poppy {
 				ImGui::SetNextItemWidth(width);
 				if (dragFloat3Pretty("##orientation", euler.data())) {
 					transform.orientation = mtl::to_quaternion(euler / 180);
+					entity.scene().markTransformDirty(entity);
 				}
 				
 				beginProperty("Scale");
 				ImGui::SetNextItemWidth(width);
 				auto const oldScale = transform.scale;
-				if (dragFloat3Pretty("##scale", transform.scale.data(), 0.02) && transformScaleLinked) {
-					bool3 const edited = mtl::map(transform.scale, oldScale, utl::unequals);
-					if (edited.x) {
-						transform.scale = transform.scale.x;
-					}
-					else if (edited.y) {
-						transform.scale = transform.scale.y;
-					}
-					else {
-						transform.scale = transform.scale.z;
+				if (dragFloat3Pretty("##scale", transform.scale.data(), 0.02)) {
+					if (transformScaleLinked) {
+						bool3 const edited = mtl::map(transform.scale, oldScale, utl::unequals);
+						if (edited.x) {
+							transform.scale = transform.scale.x;
+						}
+						else if (edited.y) {
+							transform.scale = transform.scale.y;
+						}
+						else {
+							transform.scale = transform.scale.z;
+						}
 					}
+					entity.scene().markTransformDirty(entity);
 				}
 				ImGui::SameLine();
 				auto* const iconFont = icons.font(IconSize::_16);
@@ -259,6 +264,7 @@ namespace poppy {
 			
 		auto& meshRenderer = entity.get<MeshRendererComponent>();
 		meshRenderer.mesh = std::move(asset);
+		entity.scene().markBoundsDirty(entity);
 	}
 	
 	void EntityInspector::recieveMaterialDragDrop(bloom::EntityHandle entity) {
@@ -140,7 +140,7 @@ namespace poppy {
 			dragDropTarget(EntityHandle(EntityID{}, &scene));
 
 			if (isExpanded) {
-				for (auto id: scene.gatherRoots()) {
+				for (auto id: scene.roots()) {
 					displayEntity(scene.getHandle(id));
 				}
 			}
@@ -190,8 +190,7 @@ namespace poppy {
 			}
 			
 			if (isExpanded) {
-				auto const children = e.scene().gatherChildren(e);
-				for (auto c: children) {
+				for (auto c: e.scene().children(e)) {
 					displayEntity(e.scene().getHandle(c));
 				}
 			}
@@ -121,13 +121,14 @@ namespace poppy {
 		}
 		
 		if (!usedLastFrame && _input && _input->keyDown(Key::leftShift)) {
-			entity = scene.cloneEntity(entity);
+			entity = scene.cloneSubtree(entity);
 			selection.select(entity);
 		}
 		
 		auto const newLocalTransform = mtl::inverse(parentTransform) * newEntityWSTransform;
 		
 		entity.get<Transform>() = Transform::fromMatrix(newLocalTransform);
+		scene.markTransformDirty(entity);
 	}
 	
 	void Gizmo::ImGuizmoDeleter::operator()(ImGuizmoCtx* ctx) const {
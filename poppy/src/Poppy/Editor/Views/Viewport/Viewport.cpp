@@ -216,10 +216,19 @@ namespace poppy{
 		
 		
 		auto& sceneSystem = editor().coreSystems().sceneSystem();
-		sceneSystem.applyTransformHierarchy();
-		
+		if (isSimulating()) {
+			// The simulation owns the scenes while running, draw what it published last.
+			drawScene(sceneSystem.renderSnapshot());
+		}
+		else {
+			sceneSystem.applyTransformHierarchy();
+			drawScene(sceneSystem.scenes());
+		}
+	}
+	
+	void Viewport::drawScene(auto const& source) {
 		if (gameView) {
-			sceneRenderer.draw(sceneSystem.scenes(),
+			sceneRenderer.draw(source,
 							   camera.camera,
 							   *framebuffer,
 							   window().commandQueue());
@@ -227,7 +236,7 @@ namespace poppy{
 		else {
 			OverlayDrawDescription desc;
 			
-			sceneRenderer.drawWithOverlays(sceneSystem.scenes(),
+			sceneRenderer.drawWithOverlays(source,
 										   editor().selection(),
 										   camera.camera,
 										   desc,
@@ -249,6 +258,10 @@ namespace poppy{
 	}
 	
 	void Viewport::onInput(bloom::InputEvent& event) {
+		if (gameView && viewportHovered && isSimulating()) {
+			editor().coreSystems().runtime().submitInput(event);
+		}
+		
 		event.dispatch<bloom::InputEventType::leftMouseDown>([&](bloom::MouseEvent const& e) {
 			if (!viewportHovered || gizmo.isHovered() || gameView) {
 				return false;
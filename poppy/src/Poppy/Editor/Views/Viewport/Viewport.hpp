@@ -42,6 +42,8 @@ namespace poppy {
 		void* selectImage() const;
 		void displayScene();
 		void drawScene();
+		/// \p source is either a range of scenes or a \p bloom::RenderSnapshot.
+		void drawScene(auto const& source);
 		void updateFramebuffer();
 		
 		void dropdownMenu();
@@ -118,6 +118,9 @@ namespace poppy {
 	void EditorRenderer::submitSelected(Reference<StaticMeshRenderer> mesh,
 										mtl::float4x4 const& transform)
 	{
+		if (!mesh) {
+			return;
+		}
 		selectedObjects.push_back({ mesh, mtl::transpose(transform) });
 	}
 	
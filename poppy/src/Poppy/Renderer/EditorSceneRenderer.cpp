@@ -4,6 +4,7 @@
 #include "Poppy/Editor/SelectionContext.hpp"
 
 #include "Bloom/Graphics/StaticMesh.hpp"
+#include "Bloom/Graphics/Renderer/RenderSnapshot.hpp"
 #include "Bloom/Scene/Scene.hpp"
 #include "Bloom/Scene/Components/Transform.hpp"
 #include "Bloom/Scene/Components/MeshRenderer.hpp"
@@ -20,6 +21,17 @@ namespace poppy {
 		if (!editorRenderer) {
 			return;
 		}
+		if (auto* const snapshot = currentSnapshot()) {
+			// The scenes may be modified by the simulation right now, only read the snapshot.
+			for (auto entity: mSelection->entities()) {
+				for (auto const& draw: snapshot->meshes) {
+					if (draw.scene == &entity.scene() && draw.entity == entity.id()) {
+						editorRenderer->submitSelected(draw.mesh, draw.transform);
+					}
+				}
+			}
+			return;
+		}
 		for (auto entity: mSelection->entities()) {
 			if (!entity.has<MeshRendererComponent>() ||
 				!entity.has<TransformMatrixComponent>()) {
@@ -42,12 +54,37 @@ namespace poppy {
 											   EditorFramebuffer& editorFramebuffer,
 											   CommandQueue& commandQueue)
 	{
+		setOverlays(selection, drawDesc);
+		SceneRenderer::draw(scenes, camera, framebuffer, commandQueue);
+		drawOverlays(drawDesc, framebuffer, editorFramebuffer, commandQueue);
+	}
+	
+	void EditorSceneRenderer::drawWithOverlays(RenderSnapshot const& snapshot,
+											   SelectionContext const& selection,
+											   Camera const& camera,
+											   OverlayDrawDescription const& drawDesc,
+											   Framebuffer& framebuffer,
+											   EditorFramebuffer& editorFramebuffer,
+											   CommandQueue& commandQueue)
+	{
+		setOverlays(selection, drawDesc);
+		SceneRenderer::draw(snapshot, camera, framebuffer, commandQueue);
+		drawOverlays(drawDesc, framebuffer, editorFramebuffer, commandQueue);
+	}
+	
+	void EditorSceneRenderer::setOverlays(SelectionContext const& selection, OverlayDrawDescription const& drawDesc) {
 		mSelection = &selection;
 		mDrawDesc = drawDesc;
 		if (selection.empty()) {
 			mDrawDesc.drawSelection = false;
 		}
-		SceneRenderer::draw(scenes, camera, framebuffer, commandQueue);
+	}
+	
+	void EditorSceneRenderer::drawOverlays(OverlayDrawDescription const& drawDesc,
+										   Framebuffer& framebuffer,
+										   EditorFramebuffer& editorFramebuffer,
+										   CommandQueue& commandQueue)
+	{
 		if (auto* const editorRenderer = dynamic_cast<EditorRenderer*>(&renderer())) {
 			editorRenderer->drawOverlays(framebuffer, editorFramebuffer, commandQueue, drawDesc);
 		}
@@ -21,9 +21,21 @@ namespace poppy {
 							  bloom::Framebuffer&,
 							  EditorFramebuffer&,
 							  bloom::CommandQueue&);
+		void drawWithOverlays(bloom::RenderSnapshot const&,
+							  SelectionContext const&,
+							  bloom::Camera const&,
+							  OverlayDrawDescription const&,
+							  bloom::Framebuffer&,
+							  EditorFramebuffer&,
+							  bloom::CommandQueue&);
 		
 	private:
 		void submitExtra() override;
+		void setOverlays(SelectionContext const&, OverlayDrawDescription const&);
+		void drawOverlays(OverlayDrawDescription const&,
+						  bloom::Framebuffer&,
+						  EditorFramebuffer&,
+						  bloom::CommandQueue&);
 		
 	private:
 		SelectionContext const* mSelection = nullptr;
@@ -21,6 +21,15 @@ sysincludedirs {
     "external", "external/utility"
 }
 
+newoption {
+    trigger     = "headless",
+    description = "Build without window system and Metal, e.g. to simulate scenes with the Runner on a server"
+}
+
+filter "options:headless"
+    defines "BLOOM_HEADLESS"
+filter {}
+
 targetdir("build/bin/%{cfg.longname}")
 objdir("build/obj/%{cfg.longname}")
 
@@ -43,7 +52,11 @@ filter {}
 -- Projects
 include "Bloom"
 include "Bloom/tests.lua"
-include "Poppy"
+include "Bloom/benchmarks.lua"
+if not _OPTIONS["headless"] then
+    include "Poppy"
+end
+include "Runner"
 
 -- Externals
 --include "external/glfw"
@@ -0,0 +1,23 @@
+project "Runner"
+location "."
+kind "ConsoleApp"
+language "C++"
+
+includedirs {
+    "src",
+    "../Bloom/src",
+}
+
+files {
+    "src/Runner/**.hpp",
+    "src/Runner/**.cpp",
+}
+
+-- Runs headless and needs neither window system nor GPU, so Bloom may be built with 'premake5 --headless'.
+links {
+    "Bloom",
+    "Utility",
+    "YAML",
+}
+
+removefiles "./**-depr.**"
@@ -0,0 +1,233 @@
+#include "Runner.hpp"
+
+#include "Bloom/Asset/AssetManager.hpp"
+#include "Bloom/Runtime/JobSystem.hpp"
+#include "Bloom/Runtime/Replay.hpp"
+#include "Bloom/Runtime/SceneSystem.hpp"
+#include "Bloom/Runtime/ScriptSystem.hpp"
+#include "Bloom/ScriptEngine/ScriptEngine.hpp"
+
+#include <utl/format.hpp>
+#include <utl/stopwatch.hpp>
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string_view>
+
+using namespace bloom;
+
+Application* bloom::createApplication() {
+	return new runner::Runner();
+}
+
+namespace runner {
+	
+	static constexpr std::string_view usage =
+		"Usage: Runner <project-dir> <scene> [--steps N] [--rate N] [--replay FILE] [--record FILE] [--convert FORMAT]\n"
+		"  --steps N         Number of fixed steps to run (default 1000)\n"
+		"  --rate N          Steps per simulated second (default 50)\n"
+		"  --replay FILE     Run the steps and input of a recording instead\n"
+		"  --record FILE     Record the steps that are run\n"
+		"  --convert FORMAT  Rewrite the scene as 'text' or 'binary' instead of simulating it\n";
+	
+	std::optional<std::string> parseOptions(int argc, char const* const* argv, Options& options) {
+		utl::vector<std::string_view> positional;
+		for (int i = 1; i < argc; ++i) {
+			std::string_view const arg = argv[i];
+			if (!arg.starts_with("--")) {
+				positional.push_back(arg);
+				continue;
+			}
+			if (i + 1 == argc) {
+				return utl::format("Missing value for {}", arg);
+			}
+			std::string_view const value = argv[++i];
+			auto parseCount = [&](std::size_t& out) -> std::optional<std::string> {
+				auto const [end, error] = std::from_chars(value.data(), value.data() + value.size(), out);
+				if (error != std::errc{} || end != value.data() + value.size() || out == 0) {
+					return utl::format("Invalid value for {}: {}", arg, value);
+				}
+				return std::nullopt;
+			};
+			if (arg == "--steps") {
+				if (auto error = parseCount(options.steps)) {
+					return error;
+				}
+			}
+			else if (arg == "--rate") {
+				if (auto error = parseCount(options.stepsPerSecond)) {
+					return error;
+				}
+			}
+			else if (arg == "--replay") {
+				options.replay = value;
+			}
+			else if (arg == "--record") {
+				options.record = value;
+			}
+			else if (arg == "--convert") {
+				if (value == "text") {
+					options.convert = FileFormat::text;
+				}
+				else if (value == "binary") {
+					options.convert = FileFormat::binary;
+				}
+				else {
+					return utl::format("Invalid value for {}: {}", arg, value);
+				}
+			}
+			else {
+				return utl::format("Unknown option {}", arg);
+			}
+		}
+		if (positional.size() != 2) {
+			return std::string("Expected a project directory and a scene");
+		}
+		options.project = positional[0];
+		options.scene = positional[1];
+		return std::nullopt;
+	}
+	
+	namespace {
+		/// Forwards to the scene system and measures the duration of every step.
+		struct TimingDelegate: RuntimeDelegate {
+			explicit TimingDelegate(RuntimeDelegate& target, ReplayWriter* recorder):
+				target(target), recorder(recorder) {}
+			
+			void start() override { target.start(); }
+			void stop() override { target.stop(); }
+			void input(std::span<InputEvent const> events) override {
+				stepInput.assign(events.begin(), events.end());
+				target.input(events);
+			}
+			void step(Timestep timestep) override {
+				if (recorder) {
+					recorder->writeStep(timestep, stepInput);
+				}
+				utl::precise_stopwatch stopwatch;
+				target.step(timestep);
+				stepTimes.push_back(stopwatch.elapsed_time());
+				stepInput.clear();
+			}
+			
+			RuntimeDelegate& target;
+			ReplayWriter* recorder;
+			utl::vector<InputEvent> stepInput;
+			utl::vector<std::size_t> stepTimes;
+		};
+		
+		void printStatistics(utl::vector<std::size_t> stepTimes) {
+			if (stepTimes.empty()) {
+				std::cout << "No steps were run\n";
+				return;
+			}
+			std::sort(stepTimes.begin(), stepTimes.end());
+			auto const percentile = [&](double p) {
+				return stepTimes[std::min(stepTimes.size() - 1, std::size_t(p * stepTimes.size()))] / 1000.0;
+			};
+			std::size_t const total = std::accumulate(stepTimes.begin(), stepTimes.end(), std::size_t(0));
+			std::cout << utl::format("Steps:      {}\n", stepTimes.size());
+			std::cout << utl::format("Total:      {:.3f} ms\n", total / 1'000'000.0);
+			std::cout << utl::format("Throughput: {:.1f} steps/s\n", stepTimes.size() / (total / 1'000'000'000.0));
+			std::cout << utl::format("Step [us]:  mean {:.1f}, min {:.1f}, p50 {:.1f}, p95 {:.1f}, p99 {:.1f}, max {:.1f}\n",
+									 total / 1000.0 / stepTimes.size(),
+									 stepTimes.front() / 1000.0,
+									 percentile(0.50),
+									 percentile(0.95),
+									 percentile(0.99),
+									 stepTimes.back() / 1000.0);
+		}
+	}
+	
+	void Runner::init() {
+		auto const args = commandLineArgs();
+		Options options;
+		if (auto const error = parseOptions(args.argc, args.argv, options)) {
+			std::cerr << *error << "\n" << usage;
+			setExitCode(2);
+			return;
+		}
+		try {
+			setExitCode(simulate(options));
+		}
+		catch (std::exception const& e) {
+			std::cerr << "Error: " << e.what() << "\n";
+			setExitCode(1);
+		}
+	}
+	
+	int Runner::simulate(Options const& options) {
+		// The asset manager creates missing working directories, which is not what a typo should do.
+		if (!std::filesystem::is_directory(options.project)) {
+			std::cerr << utl::format("Project directory {} does not exist\n", options.project.string());
+			return 1;
+		}
+		auto& assetManager = coreSystems().assetManager();
+		assetManager.setWorkingDir(std::filesystem::absolute(options.project));
+		
+		auto const scenePath = options.scene.is_absolute() ? options.scene : assetManager.workingDir() / options.scene;
+		AssetHandle const handle = assetManager.getHandleFromFile(scenePath);
+		auto const scene = as<Scene>(assetManager.get(handle));
+		if (handle.type() != AssetType::scene || !scene) {
+			std::cerr << utl::format("{} is not a scene of the project\n", options.scene.string());
+			return 1;
+		}
+		if (options.convert) {
+			assetManager.convertScene(handle, *options.convert);
+			std::cout << utl::format("Converted {} to {}\n", options.scene.string(),
+									 *options.convert == FileFormat::binary ? "binary" : "text");
+			return 0;
+		}
+		assetManager.makeAvailable(handle, AssetRepresentation::CPU);
+		
+		// Meshes need their bounds before the first step.
+		assetManager.finishPendingLoads();
+		
+		assetManager.loadScripts(coreSystems().scriptEngine());
+		
+		auto& sceneSystem = coreSystems().sceneSystem();
+		sceneSystem.systems().add(coreSystems().scriptSystem().updateSystem());
+		sceneSystem.loadScene(scene);
+		
+		std::ofstream recordFile;
+		std::optional<ReplayWriter> recorder;
+		if (!options.record.empty()) {
+			recordFile.open(options.record, std::ios::binary);
+			if (!recordFile) {
+				std::cerr << utl::format("Failed to open {}\n", options.record.string());
+				return 1;
+			}
+			recorder.emplace(recordFile, ReplayHeader{ .stepsPerSecond = static_cast<std::uint32_t>(options.stepsPerSecond) });
+		}
+		TimingDelegate delegate(sceneSystem, recorder ? &*recorder : nullptr);
+		
+		std::cout << utl::format("Simulating {} on {} worker threads\n",
+								 options.scene.string(), coreSystems().jobSystem().workerCount());
+		if (!options.replay.empty()) {
+			std::ifstream replayFile(options.replay, std::ios::binary);
+			if (!replayFile) {
+				std::cerr << utl::format("Failed to open {}\n", options.replay.string());
+				return 1;
+			}
+			ReplayReader reader(replayFile);
+			replay(reader, delegate);
+		}
+		else {
+			double const delta = 1.0 / options.stepsPerSecond;
+			delegate.start();
+			for (std::size_t i = 1; i <= options.steps; ++i) {
+				delegate.step(Timestep{ .absolute = i * delta, .delta = delta });
+			}
+			delegate.stop();
+		}
+		if (recorder) {
+			recorder->finish();
+		}
+		
+		printStatistics(delegate.stepTimes);
+		return 0;
+	}
+	
+}
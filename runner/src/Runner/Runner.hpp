@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Bloom/Application/Application.hpp"
+#include "Bloom/Asset/Asset.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace runner {
+	
+	struct Options {
+		/// Project directory, loaded as working directory of the asset manager.
+		std::filesystem::path project;
+		/// Scene to simulate, relative to the project directory or absolute.
+		std::filesystem::path scene;
+		std::size_t steps = 1000;
+		std::size_t stepsPerSecond = 50;
+		/// Replays this recording instead of running \p steps empty steps.
+		std::filesystem::path replay;
+		/// Records the steps that were run to this file.
+		std::filesystem::path record;
+		/// Rewrites the scene in this format instead of simulating it.
+		std::optional<bloom::FileFormat> convert;
+	};
+	
+	/// Parses the command line. Returns an error message if the arguments are invalid.
+	std::optional<std::string> parseOptions(int argc, char const* const* argv, Options& options);
+	
+	/// Simulates a scene of a project without window or GPU and prints timing statistics.
+	class Runner: public bloom::Application {
+	public:
+		bool isHeadless() const override { return true; }
+		void init() override;
+	
+	private:
+		int simulate(Options const&);
+	};
+	
+}